@@ -0,0 +1,187 @@
+#include <chrono>
+#include "asyncmonitor.h"
+using namespace std;
+
+AsyncMonitor::AsyncMonitor(size_t capacity) : events(capacity) {
+    monitor_time = 0;
+    stopping = false;
+    thread = std::thread(&AsyncMonitor::consume, this);
+}
+
+AsyncMonitor::~AsyncMonitor() {
+    stopping = true;
+    thread.join();
+}
+
+// Monitor thread: replays the events until the monitor is destroyed. While
+// the ring is empty it first yields, then sleeps, so an idle simulation does
+// not keep a core busy.
+void AsyncMonitor::consume() {
+    int idle = 0;
+    while (true) {
+        const Event *event = events.front();
+        if (event) {
+            replay(*event);
+            events.pop();
+            idle = 0;
+        } else if (stopping) {
+            break;
+        } else if (++idle < 100) {
+            this_thread::yield();
+        } else {
+            this_thread::sleep_for(chrono::microseconds(50));
+        }
+    }
+}
+
+void AsyncMonitor::replay(const Event &event) {
+    advance_monitors(event.tick);
+
+    const Task *t = tasks[event.task];
+    const Processor *p = processors[event.processor];
+    for (auto m : monitors) {
+        if (event.kind == EVENT_PREEMPTED) {
+            m->task_preempted(t, p);
+        } else {
+            m->task_resumed(t, p);
+        }
+    }
+}
+
+void AsyncMonitor::advance_monitors(int time) const {
+    if (time != monitor_time) {
+        for (auto m : monitors) {
+            m->advance_time(time - monitor_time);
+        }
+        monitor_time = time;
+    }
+}
+
+// Waits until the monitor thread has replayed every event. Afterwards the
+// wrapped monitors can be used from this thread until the next event.
+void AsyncMonitor::flush() const {
+    while (!events.empty()) {
+        this_thread::yield();
+    }
+}
+
+// Flushes and brings the wrapped monitors up to the current time
+void AsyncMonitor::synchronize() const {
+    flush();
+    advance_monitors(get_time());
+}
+
+// The ring holds as many events as the monitors are behind; when it is full,
+// the simulation waits for them
+void AsyncMonitor::push(int kind, const Task *t, const Processor *p) {
+    Event event = { get_time(), t->get_id(), p->get_id(), kind };
+    while (!events.push(event)) {
+        this_thread::yield();
+    }
+}
+
+void AsyncMonitor::add_monitor(Monitor *monitor) {
+    synchronize();
+    monitors.push_back(monitor);
+}
+
+void AsyncMonitor::add_processor(const Processor *p) {
+    synchronize();
+    if (p->get_id() >= static_cast<int>(processors.size())) {
+        processors.resize(p->get_id() + 1, NULL);
+    }
+    processors[p->get_id()] = p;
+    for (auto m : monitors) {
+        m->add_processor(p);
+    }
+}
+
+void AsyncMonitor::add_task(const Task *t) {
+    synchronize();
+    if (t->get_id() >= static_cast<int>(tasks.size())) {
+        tasks.resize(t->get_id() + 1, NULL);
+    }
+    tasks[t->get_id()] = t;
+    for (auto m : monitors) {
+        m->add_task(t);
+    }
+}
+
+void AsyncMonitor::task_preempted(const Task *t, const Processor *p) {
+    push(EVENT_PREEMPTED, t, p);
+}
+
+void AsyncMonitor::task_resumed(const Task *t, const Processor *p) {
+    push(EVENT_RESUMED, t, p);
+}
+
+void AsyncMonitor::simulation_finished() {
+    synchronize();
+    for (auto m : monitors) {
+        m->simulation_finished();
+    }
+}
+
+void AsyncMonitor::set_parameter(const Task *task, SchedulingParameter param, const void *value) {
+    synchronize();
+    for (auto m : monitors) {
+        m->set_parameter(task, param, value);
+    }
+}
+
+bool AsyncMonitor::can_extrapolate() const {
+    synchronize();
+    for (auto m : monitors) {
+        if (!m->can_extrapolate()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AsyncMonitor::mark_period() {
+    synchronize();
+    for (auto m : monitors) {
+        m->mark_period();
+    }
+}
+
+void AsyncMonitor::extrapolate(int periods, int length) {
+    synchronize();
+    for (auto m : monitors) {
+        m->extrapolate(periods, length);
+    }
+}
+
+int AsyncMonitor::get_num_sections() const {
+    int sections = 0;
+    for (auto m : monitors) {
+        sections += m->get_num_sections();
+    }
+    return sections;
+}
+
+bool AsyncMonitor::save_sections(vector<vector<int> > &sections) const {
+    synchronize();
+    for (auto m : monitors) {
+        if (!m->save_sections(sections)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AsyncMonitor::restore_sections(const vector<int> *sections, int tick) {
+    synchronize();
+    for (auto m : monitors) {
+        if (!m->restore_sections(sections, tick)) {
+            return false;
+        }
+        sections += m->get_num_sections();
+    }
+
+    // The monitors restored their own time
+    set_time(tick);
+    monitor_time = tick;
+    return true;
+}
@@ -0,0 +1,68 @@
+#ifndef ASYNCMONITOR_H
+#define ASYNCMONITOR_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "monitor.h"
+#include "eventring.h"
+
+// Runs other monitors on a thread of their own. Registered as the only
+// monitor of a kernel, it appends every task switch as a compact event to a
+// ring, and the monitor thread replays the events on the monitors it wraps.
+// The simulation only waits for the monitors when the ring is full and for
+// the calls that need their state (simulation_finished(), steady-state and
+// checkpoint support), which first let the monitor thread catch up.
+class AsyncMonitor : public Monitor {
+    enum EventKind {
+        EVENT_PREEMPTED,
+        EVENT_RESUMED
+    };
+
+    struct Event {
+        int tick;
+        int task;           // Task id
+        int processor;      // Processor id
+        int kind;
+    };
+
+    std::vector<Monitor*> monitors;
+    std::vector<const Task*> tasks;             // Indexed by task id
+    std::vector<const Processor*> processors;   // Indexed by processor id
+    EventRing<Event> events;
+    mutable int monitor_time;       // Time of the wrapped monitors
+    std::atomic<bool> stopping;
+    std::thread thread;
+
+    void push(int kind, const Task *t, const Processor *p);
+    void consume();
+    void replay(const Event &event);
+    void advance_monitors(int time) const;
+    void flush() const;
+    void synchronize() const;
+
+public:
+    explicit AsyncMonitor(size_t capacity = 1 << 16);
+    ~AsyncMonitor();
+
+    // Monitors are added before any task or processor
+    void add_monitor(Monitor *monitor);
+
+    void add_processor(const Processor *p);
+    void add_task(const Task *t);
+    void task_preempted(const Task *t, const Processor *p);
+    void task_resumed(const Task *t, const Processor *p);
+    void simulation_finished();
+    void set_parameter(const Task *task, SchedulingParameter param, const void *value);
+
+    bool can_extrapolate() const;
+    void mark_period();
+    void extrapolate(int periods, int length);
+
+    // The sections of the wrapped monitors, as if they were registered directly
+    int get_num_sections() const;
+    bool save_sections(std::vector<std::vector<int> > &sections) const;
+    bool restore_sections(const std::vector<int> *sections, int tick);
+};
+
+#endif // ASYNCMONITOR_H
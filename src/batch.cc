@@ -0,0 +1,340 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "schedsim_main.h"
+#include "csv.h"
+using namespace std;
+
+// Batch driver: runs one simulator process per system XML file on a pool of
+// workers pinned to the available cores, and aggregates the statistics of all
+// runs into a single CSV on stdout. Every job runs in its own working directory,
+// so trace files of concurrent runs do not clash, and a failing simulation only
+// affects its own row. With -f, systems that fail the schedulability analysis
+// are not simulated and show up as "infeasible".
+
+struct Job {
+    string xml_file;
+    string work_dir;
+    int status;
+};
+
+struct Worker {
+    pid_t pid;
+    int cpu;
+    int job;
+};
+
+static void usage(const char *name) {
+    cerr << "Usage: " << name << " [-j workers] [-x simulator] [-t simulation-time] [-d work-dir] [-k] [-f] <xml-file|directory|list-file>..." << endl;
+}
+
+static bool ends_with(const string &s, const string &suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static string absolute_path(const string &path) {
+    char buf[PATH_MAX];
+    if (!realpath(path.c_str(), buf)) {
+        return "";
+    }
+    return buf;
+}
+
+// Collects the xml files from a directory, a list file (one path per line) or a single xml file
+static bool collect_jobs(const string &arg, vector<Job> &jobs) {
+    struct stat st;
+    if (stat(arg.c_str(), &st) != 0) {
+        cerr << "Couldn't open '" << arg << "'" << endl;
+        return false;
+    }
+
+    vector<string> files;
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(arg.c_str());
+        if (!dir) {
+            cerr << "Couldn't open directory '" << arg << "'" << endl;
+            return false;
+        }
+        for (struct dirent *entry = readdir(dir); entry; entry = readdir(dir)) {
+            string name = entry->d_name;
+            if (ends_with(name, ".xml")) {
+                files.push_back(arg + "/" + name);
+            }
+        }
+        closedir(dir);
+        sort(files.begin(), files.end());
+    } else if (ends_with(arg, ".xml")) {
+        files.push_back(arg);
+    } else {
+        ifstream list(arg);
+        string line;
+        while (getline(list, line)) {
+            if (!line.empty()) {
+                files.push_back(line);
+            }
+        }
+    }
+
+    for (const auto &f : files) {
+        Job job;
+        job.xml_file = f;
+        job.status = -1;
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+static void remove_dir(const string &path) {
+    DIR *dir = opendir(path.c_str());
+    if (!dir) return;
+    for (struct dirent *entry = readdir(dir); entry; entry = readdir(dir)) {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+            unlink((path + "/" + entry->d_name).c_str());
+        }
+    }
+    closedir(dir);
+    rmdir(path.c_str());
+}
+
+static pid_t start_job(const Job &job, int cpu, const string &simulator, const string &simulation_time, bool filter) {
+    string xml = absolute_path(job.xml_file);
+
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+
+    // Child: pin to the worker's core and run the simulator in the job directory
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    sched_setaffinity(0, sizeof(cpus), &cpus);
+
+    if (xml.empty() || chdir(job.work_dir.c_str()) != 0) {
+        _exit(126);
+    }
+
+    int fd = open("log.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+    }
+
+    vector<char*> args;
+    args.push_back(const_cast<char*>(simulator.c_str()));
+    args.push_back(const_cast<char*>("-s"));
+    args.push_back(const_cast<char*>("stats.csv"));
+    if (filter) {
+        args.push_back(const_cast<char*>("-f"));
+    }
+    args.push_back(const_cast<char*>(xml.c_str()));
+    if (!simulation_time.empty()) {
+        args.push_back(const_cast<char*>(simulation_time.c_str()));
+    }
+    args.push_back(NULL);
+
+    execv(simulator.c_str(), &args[0]);
+    _exit(127);
+}
+
+// Kills the simulations that are still running and waits for them, so no
+// children are left behind when the batch is aborted
+static void stop_workers(vector<Worker> &workers) {
+    for (auto &w : workers) {
+        if (w.pid > 0) {
+            kill(w.pid, SIGKILL);
+        }
+    }
+    for (auto &w : workers) {
+        if (w.pid > 0) {
+            waitpid(w.pid, NULL, 0);
+            w.pid = 0;
+        }
+    }
+}
+
+static string status_string(int status, bool filter) {
+    if (WIFEXITED(status)) {
+        if (WEXITSTATUS(status) == 0) return "ok";
+        if (filter && WEXITSTATUS(status) == schedsim_exit_infeasible) return "infeasible";
+        return "exit " + to_string(WEXITSTATUS(status));
+    } else if (WIFSIGNALED(status)) {
+        return "signal " + to_string(WTERMSIG(status));
+    }
+    return "unknown";
+}
+
+int main(int argc, char *argv[]) {
+    int num_workers = 0;
+    string simulator, simulation_time, work_dir;
+    bool keep = false, filter = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:x:t:d:kf")) != -1) {
+        switch (opt) {
+            case 'j':
+                num_workers = atoi(optarg);
+                break;
+            case 'x':
+                simulator = optarg;
+                break;
+            case 't':
+                simulation_time = optarg;
+                break;
+            case 'd':
+                work_dir = optarg;
+                break;
+            case 'k':
+                keep = true;
+                break;
+            case 'f':
+                filter = true;
+                break;
+            default:
+                usage(argv[0]);
+                return -1;
+        }
+    }
+
+    if (optind >= argc) {
+        usage(argv[0]);
+        return -1;
+    }
+
+    vector<Job> jobs;
+    for (int i = optind; i < argc; i++) {
+        if (!collect_jobs(argv[i], jobs)) {
+            return -1;
+        }
+    }
+
+    // By default, use the schedule-only simulator next to this binary
+    if (simulator.empty()) {
+        string self = argv[0];
+        size_t slash = self.rfind('/');
+        simulator = (slash == string::npos ? string(".") : self.substr(0, slash)) + "/schedsim.bin";
+    }
+    string sim_path = absolute_path(simulator);
+    if (sim_path.empty() || access(sim_path.c_str(), X_OK) != 0) {
+        cerr << "Simulator '" << simulator << "' not found" << endl;
+        return -1;
+    }
+
+    // One worker per core that we are allowed to run on
+    vector<int> cpus;
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &allowed)) cpus.push_back(c);
+        }
+    }
+    if (cpus.empty()) {
+        cpus.push_back(0);
+    }
+    if (num_workers <= 0) {
+        num_workers = cpus.size();
+    }
+
+    bool remove_work_dir = false;
+    if (work_dir.empty()) {
+        char tmpl[] = "/tmp/rtsim-batch-XXXXXX";
+        if (!mkdtemp(tmpl)) {
+            cerr << "Couldn't create working directory" << endl;
+            return -1;
+        }
+        work_dir = tmpl;
+        remove_work_dir = !keep;
+    } else {
+        mkdir(work_dir.c_str(), 0755);
+    }
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        jobs[i].work_dir = work_dir + "/" + to_string(i);
+        mkdir(jobs[i].work_dir.c_str(), 0755);
+    }
+
+    vector<Worker> workers(num_workers);
+    for (int w = 0; w < num_workers; w++) {
+        workers[w].pid = 0;
+        workers[w].cpu = cpus[w % cpus.size()];
+        workers[w].job = -1;
+    }
+
+    size_t next_job = 0;
+    size_t finished = 0;
+    while (finished < jobs.size()) {
+        // Fill idle workers
+        for (auto &w : workers) {
+            if (w.pid == 0 && next_job < jobs.size()) {
+                w.pid = start_job(jobs[next_job], w.cpu, sim_path, simulation_time, filter);
+                if (w.pid < 0) {
+                    cerr << "Couldn't start simulation for '" << jobs[next_job].xml_file << "'" << endl;
+                    w.pid = 0;
+                    stop_workers(workers);
+                    return -1;
+                }
+                w.job = next_job++;
+            }
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Error: waiting for the simulations failed: " << strerror(errno) << endl;
+            stop_workers(workers);
+            return -1;
+        }
+        for (auto &w : workers) {
+            if (w.pid == pid) {
+                jobs[w.job].status = status;
+                w.pid = 0;
+                finished++;
+                break;
+            }
+        }
+    }
+
+    // Aggregate results, in job order
+    cout << "file,status,kind,name,metric,value" << endl;
+    for (auto &job : jobs) {
+        string status = status_string(job.status, filter);
+        ifstream stats(job.work_dir + "/stats.csv");
+        string line;
+        bool have_stats = false;
+        if (status == "ok") {
+            while (getline(stats, line)) {
+                cout << csv_field(job.xml_file) << "," << status << "," << line << endl;
+                have_stats = true;
+            }
+        }
+        if (!have_stats) {
+            cout << csv_field(job.xml_file) << "," << status << ",,,," << endl;
+        }
+
+        if (!keep) {
+            remove_dir(job.work_dir);
+        }
+    }
+
+    if (remove_work_dir) {
+        rmdir(work_dir.c_str());
+    }
+
+    return 0;
+}
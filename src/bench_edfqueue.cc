@@ -0,0 +1,120 @@
+#include <iostream>
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include "scheduler.h"
+#include "edfqueue.h"
+using namespace std;
+
+// Microbenchmark for the EDF ready/waiting queues: compares a priority_queue of
+// Task pointers, whose comparator reaches the deadline through the task data,
+// with the inline-key EDFQueue. Uses the classic hold model: the queue is filled
+// with N tasks, then every operation pops the earliest deadline and re-queues
+// that task with a later deadline.
+
+class BenchData : public TaskData {
+public:
+    int abs_deadline;
+};
+
+struct greater_deadline {
+    bool operator()(Task *x, Task *y) const {
+        BenchData *data_x = static_cast<BenchData*>(x->get_taskdata());
+        BenchData *data_y = static_cast<BenchData*>(y->get_taskdata());
+        return data_x->abs_deadline > data_y->abs_deadline;
+    }
+};
+
+static double bench_priority_queue(vector<Task*> &tasks, const vector<int> &increments, int ops) {
+    priority_queue<Task*, vector<Task*>, greater_deadline> queue;
+    for (auto task : tasks) {
+        queue.push(task);
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < ops; i++) {
+        Task *task = queue.top();
+        queue.pop();
+        BenchData *data = static_cast<BenchData*>(task->get_taskdata());
+        data->abs_deadline += increments[i % increments.size()];
+        queue.push(task);
+    }
+    auto end = chrono::steady_clock::now();
+
+    return chrono::duration<double, nano>(end - start).count() / ops;
+}
+
+static double bench_edf_queue(vector<Task*> &tasks, const vector<int> &increments, int ops) {
+    EDFQueue queue;
+    vector<int> deadlines(tasks.size());
+    for (size_t i = 0; i < tasks.size(); i++) {
+        deadlines[i] = static_cast<BenchData*>(tasks[i]->get_taskdata())->abs_deadline;
+        queue.push(i, deadlines[i]);
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < ops; i++) {
+        int task = queue.top();
+        queue.pop();
+        deadlines[task] += increments[i % increments.size()];
+        queue.push(task, deadlines[task]);
+    }
+    auto end = chrono::steady_clock::now();
+
+    return chrono::duration<double, nano>(end - start).count() / ops;
+}
+
+int main(int argc, char *argv[]) {
+    int ops = 1000000;
+    if (argc > 1) {
+        ops = atoi(argv[1]);
+    }
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> period(10, 10000);
+    vector<int> increments(4096);
+    for (auto &inc : increments) {
+        inc = period(rng);
+    }
+
+    cout << "tasks,priority_queue_ns_per_op,edfqueue_ns_per_op" << endl;
+    for (int n : {100, 1000, 10000, 100000}) {
+        // Allocate the tasks interleaved with other allocations, like a loaded system would
+        vector<Task*> tasks;
+        vector<char*> padding;
+        for (int i = 0; i < n; i++) {
+            Task *task = new Task("t" + to_string(i));
+            BenchData *data = new BenchData();
+            data->abs_deadline = period(rng);
+            task->set_taskdata(data);
+            tasks.push_back(task);
+            padding.push_back(new char[64]);
+        }
+        shuffle(tasks.begin(), tasks.end(), rng);
+
+        // Both variants start from the same deadlines
+        vector<int> initial;
+        for (auto task : tasks) {
+            initial.push_back(static_cast<BenchData*>(task->get_taskdata())->abs_deadline);
+        }
+        double pq = bench_priority_queue(tasks, increments, ops);
+        for (size_t i = 0; i < tasks.size(); i++) {
+            static_cast<BenchData*>(tasks[i]->get_taskdata())->abs_deadline = initial[i];
+        }
+        double eq = bench_edf_queue(tasks, increments, ops);
+
+        cout << n << "," << pq << "," << eq << endl;
+
+        for (auto task : tasks) {
+            delete task;
+        }
+        for (auto p : padding) {
+            delete[] p;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+#include "system/systemloader.h"
+#include "system/streamingsystemloader.h"
+#include "system/systemvalidator.h"
+#include "bench_system.h"
+using namespace std;
+
+// Benchmark for loading many candidate systems in one process, as a design
+// space exploration does before it dispatches simulations: a pool of threads
+// loads and validates a set of system files, each thread with its own loader.
+// The candidates differ in how their tasks are mapped to the processors. With
+// loaders that share no state, the throughput grows with the number of threads
+// up to the number of cores.
+
+// Loads and validates all files with the given number of threads, returns
+// the time in ms, or -1 if a file could not be loaded
+template <class Loader>
+static double load_all(const vector<string> &files, int num_threads) {
+    atomic<int> next(0);
+    atomic<int> failed(0);
+
+    auto worker = [&]() {
+        Loader loader;
+        for (int i = next++; i < static_cast<int>(files.size()); i = next++) {
+            systemdata::System *system = loader.load(files[i]);
+            if (!system) {
+                failed++;
+                continue;
+            }
+
+            ostringstream errors;
+            SystemValidator sv(system, errors);
+            if (!sv.validate()) {
+                failed++;
+            }
+            delete system;
+        }
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.push_back(thread(worker));
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    auto end = chrono::steady_clock::now();
+
+    if (failed > 0) {
+        cerr << failed << " of " << files.size() << " files failed to load" << endl;
+        return -1;
+    }
+    return chrono::duration<double, milli>(end - start).count();
+}
+
+template <class Loader>
+static bool bench(const char *name, const vector<string> &files, int max_threads) {
+    cout << name << endl;
+    cout << "Threads   Time (ms)   Files/s   Speedup" << endl;
+
+    double single = -1;
+    for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        double ms = load_all<Loader>(files, num_threads);
+        if (ms < 0) {
+            return false;
+        }
+        if (single < 0) {
+            single = ms;
+        }
+        cout << num_threads << "\t  " << ms << "\t" << 1000 * files.size() / ms << "\t  " << single / ms << endl;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    int num_files = argc > 1 ? atoi(argv[1]) : 1000;
+    int num_tasks = argc > 2 ? atoi(argv[2]) : 200;
+    int max_threads = argc > 3 ? atoi(argv[3]) : thread::hardware_concurrency();
+
+    if (num_files < 1 || num_tasks < 1) {
+        cerr << "Usage: " << argv[0] << " [files] [tasks-per-file] [max-threads]" << endl;
+        return -1;
+    }
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+
+    char dir[] = "/tmp/bench_parallelload_XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    vector<string> files;
+    for (int i = 0; i < num_files; i++) {
+        files.push_back(string(dir) + "/candidate_" + to_string(i) + ".xml");
+        write_bench_system(files.back(), "candidate_" + to_string(i), num_tasks, 20, i);
+    }
+    cout << num_files << " systems with " << num_tasks << " tasks, " << thread::hardware_concurrency() << " cores" << endl;
+
+    bool ok = bench<StreamingSystemLoader>("Streaming loader", files, max_threads) &&
+              bench<SystemLoader>("DOM loader", files, max_threads);
+
+    for (auto &f : files) {
+        unlink(f.c_str());
+    }
+    rmdir(dir);
+    return ok ? 0 : 1;
+}
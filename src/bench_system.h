@@ -0,0 +1,118 @@
+#ifndef BENCH_SYSTEM_H
+#define BENCH_SYSTEM_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "system/systemdata.h"
+
+// Synthetic system of the benchmarks: num_tasks fixed tasks task_<t>, spread
+// over partitioned EDF schedulers sched_<p>, each with one processor proc_<p>
+// and a mapping mapping_<p> for tasks_per_processor tasks. Candidate 0 maps
+// the tasks in blocks, in file order. The other candidates deal them out
+// round robin, each starting at another processor, like the candidates of a
+// design space exploration that only differ in their mapping.
+//
+// The entities are passed to the sink in file order, which either writes them
+// as XML or adds them to a System.
+template <class Sink>
+void generate_bench_system(Sink &sink, int num_tasks, int tasks_per_processor, int candidate) {
+    int num_processors = (num_tasks + tasks_per_processor - 1) / tasks_per_processor;
+    std::vector<std::vector<std::string> > mapped(num_processors);
+    for (int t = 0; t < num_tasks; t++) {
+        int p = candidate == 0 ? t / tasks_per_processor : (t + candidate) % num_processors;
+        mapped[p].push_back("task_" + std::to_string(t));
+    }
+
+    for (int p = 0; p < num_processors; p++) {
+        sink.scheduler("sched_" + std::to_string(p), "mapping_" + std::to_string(p));
+    }
+    for (int t = 0; t < num_tasks; t++) {
+        int period = 100 * (1 + t % 50);
+        sink.task("task_" + std::to_string(t), t % 10, period, t + 1);
+    }
+    for (int p = 0; p < num_processors; p++) {
+        sink.processor("proc_" + std::to_string(p), "sched_" + std::to_string(p));
+    }
+    for (int p = 0; p < num_processors; p++) {
+        sink.mapping("mapping_" + std::to_string(p), "proc_" + std::to_string(p), mapped[p]);
+    }
+}
+
+class BenchXmlSink {
+    std::ostream &out;
+
+public:
+    BenchXmlSink(std::ostream &out) : out(out) {}
+
+    void scheduler(const std::string &name, const std::string &mapping) {
+        out << "    <scheduler name=\"" << name << "\" algorithm=\"EDF\" type=\"partitioned\" mapping=\"" << mapping << "\" />" << std::endl;
+    }
+
+    void task(const std::string &name, int start_time, int period, int priority) {
+        out << "    <task name=\"" << name << "\" wcet=\"1\" readDelay=\"0\" writeDelay=\"0\" startTime=\"" << start_time
+            << "\" period=\"" << period << "\" deadline=\"" << period << "\" priority=\"" << priority << "\" type=\"fixed\" />" << std::endl;
+    }
+
+    void processor(const std::string &name, const std::string &scheduler) {
+        out << "    <processor name=\"" << name << "\" scheduler=\"" << scheduler << "\" />" << std::endl;
+    }
+
+    void mapping(const std::string &name, const std::string &processor, const std::vector<std::string> &tasks) {
+        out << "    <mapping name=\"" << name << "\">" << std::endl;
+        out << "        <processor name=\"" << processor << "\">" << std::endl;
+        for (auto &task : tasks) {
+            out << "            <task name=\"" << task << "\" />" << std::endl;
+        }
+        out << "        </processor>" << std::endl;
+        out << "    </mapping>" << std::endl;
+    }
+};
+
+class BenchSystemSink {
+    systemdata::System *system;
+
+public:
+    BenchSystemSink(systemdata::System *system) : system(system) {}
+
+    void scheduler(const std::string &name, const std::string &mapping) {
+        system->addScheduler(system->createScheduler(name, systemdata::SCHED_EDF, systemdata::SCHEDTYPE_PARTITIONED, mapping));
+    }
+
+    void task(const std::string &name, int start_time, int period, int priority) {
+        system->addTask(system->createTask(name, 1, 0, 0, start_time, period, period, priority, systemdata::TASKTYPE_FIXED));
+    }
+
+    void processor(const std::string &name, const std::string &scheduler) {
+        system->addProcessor(system->createProcessor(name, scheduler));
+    }
+
+    void mapping(const std::string &name, const std::string &processor, const std::vector<std::string> &tasks) {
+        systemdata::Mapping *mapping = system->createMapping(name);
+        systemdata::Mapping::ProcessorEntry *entry = mapping->add_entry(processor);
+        for (auto &task : tasks) {
+            entry->add_task(task);
+        }
+        system->addMapping(mapping);
+    }
+};
+
+inline void write_bench_system(const std::string &filename, const std::string &system_name,
+                               int num_tasks, int tasks_per_processor, int candidate) {
+    std::ofstream out(filename.c_str());
+    BenchXmlSink sink(out);
+
+    out << "<?xml version=\"1.0\" standalone=\"no\" ?>" << std::endl;
+    out << "<system name=\"" << system_name << "\">" << std::endl;
+    generate_bench_system(sink, num_tasks, tasks_per_processor, candidate);
+    out << "</system>" << std::endl;
+}
+
+inline systemdata::System *create_bench_system(int num_tasks, int tasks_per_processor, int candidate) {
+    systemdata::System *system = new systemdata::System();
+    BenchSystemSink sink(system);
+    generate_bench_system(sink, num_tasks, tasks_per_processor, candidate);
+    return system;
+}
+
+#endif // BENCH_SYSTEM_H
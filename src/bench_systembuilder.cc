@@ -0,0 +1,48 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+#include "system/systemvalidator.h"
+#include "systembuilder.h"
+#include "schedulesimulator.h"
+#include "bench_system.h"
+using namespace std;
+
+// Startup-time benchmark: validates and builds synthetic systems of doubling
+// size, with partitioned EDF schedulers of 100 tasks each, and registers every
+// task. With linear construction the time per task stays flat as the system grows.
+
+int main(int argc, char *argv[]) {
+    int max_tasks = argc > 1 ? atoi(argv[1]) : 64000;
+
+    if (max_tasks < 1000) {
+        cerr << "Usage: " << argv[0] << " [max-tasks >= 1000]" << endl;
+        return -1;
+    }
+
+    cout << "Tasks     Validate (ms)   Build (ms)   Build per task (us)" << endl;
+    for (int num_tasks = 1000; num_tasks <= max_tasks; num_tasks *= 2) {
+        systemdata::System *system = create_bench_system(num_tasks, 100, 0);
+
+        auto start = chrono::steady_clock::now();
+        SystemValidator sv(system);
+        if (!sv.validate()) {
+            delete system;
+            return 1;
+        }
+        auto validated = chrono::steady_clock::now();
+
+        ScheduleSimulator sim;
+        SystemBuilder sb(system, &sim);
+        sb.create_tasks();
+        auto end = chrono::steady_clock::now();
+
+        double validate_ms = chrono::duration<double, milli>(validated - start).count();
+        double build_ms = chrono::duration<double, milli>(end - validated).count();
+        cout << num_tasks << "\t  " << validate_ms << "\t  " << build_ms << "\t " << 1000 * build_ms / num_tasks << endl;
+
+        delete system;
+    }
+
+    return 0;
+}
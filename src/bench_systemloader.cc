@@ -0,0 +1,158 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "system/systemloader.h"
+#include "system/streamingsystemloader.h"
+#include "system/systemvalidator.h"
+#include "system/systemsnapshot.h"
+#include "bench_system.h"
+using namespace std;
+
+// Benchmark for loading large system files: compares the DOM-based
+// SystemLoader with the StreamingSystemLoader on a synthetic system of N tasks,
+// spread over partitioned EDF schedulers of 100 tasks each. Every loader runs
+// in its own process, so its peak resident set size can be reported as well,
+// together with the time to free the loaded system. The last two lines
+// compare what a run of schedsim pays to get a validated system, without and
+// with a snapshot.
+
+class ValidatingLoader {
+public:
+    systemdata::System *load(const string &filename) {
+        StreamingSystemLoader sl;
+        systemdata::System *system = sl.load(filename);
+        if (!system) {
+            cerr << sl.get_errors();
+        } else {
+            SystemValidator sv(system);
+            if (!sv.validate()) {
+                delete system;
+                return NULL;
+            }
+        }
+        return system;
+    }
+};
+
+// Includes hashing the xml file, to check that the snapshot is up to date
+class SnapshotLoader {
+public:
+    systemdata::System *load(const string &filename) {
+        unsigned long long hash;
+        if (!SystemSnapshot::hash_file(filename, hash)) {
+            return NULL;
+        }
+        return SystemSnapshot::load(filename + ".snapshot", hash);
+    }
+};
+
+struct Result {
+    double load_ms;
+    double free_ms;
+    int num_tasks;
+};
+
+template <class Loader>
+static Result load(const string &filename, int repetitions) {
+    Result best = { -1, -1, 0 };
+    for (int i = 0; i < repetitions; i++) {
+        Loader loader;
+        auto start = chrono::steady_clock::now();
+        systemdata::System *system = loader.load(filename);
+        auto loaded = chrono::steady_clock::now();
+        if (!system) {
+            exit(1);
+        }
+        best.num_tasks = system->get_tasks().size();
+        delete system;
+        auto end = chrono::steady_clock::now();
+
+        double load_ms = chrono::duration<double, milli>(loaded - start).count();
+        double free_ms = chrono::duration<double, milli>(end - loaded).count();
+        if (best.load_ms < 0 || load_ms < best.load_ms) {
+            best.load_ms = load_ms;
+        }
+        if (best.free_ms < 0 || free_ms < best.free_ms) {
+            best.free_ms = free_ms;
+        }
+    }
+    return best;
+}
+
+// Runs the loader in a child process and prints its best times and peak memory
+template <class Loader>
+static bool bench(const char *name, const string &filename, int repetitions) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return false;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        Result result = load<Loader>(filename, repetitions);
+        if (write(fds[1], &result, sizeof(result)) != sizeof(result)) {
+            _exit(1);
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+
+    Result result;
+    bool ok = read(fds[0], &result, sizeof(result)) == sizeof(result);
+    close(fds[0]);
+
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || !ok) {
+        cerr << name << ": loading failed" << endl;
+        return false;
+    }
+
+    cout << name << ": " << result.load_ms << " ms, " << result.num_tasks << " tasks, peak RSS " << usage.ru_maxrss / 1024
+         << " MB, freed in " << result.free_ms << " ms" << endl;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    int num_tasks = argc > 1 ? atoi(argv[1]) : 100000;
+    int repetitions = argc > 2 ? atoi(argv[2]) : 3;
+
+    if (num_tasks < 1 || repetitions < 1) {
+        cerr << "Usage: " << argv[0] << " [tasks] [repetitions]" << endl;
+        return -1;
+    }
+
+    char filename[] = "/tmp/bench_systemloader_XXXXXX";
+    int fd = mkstemp(filename);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    write_bench_system(filename, "bench", num_tasks, 100, 0);
+    cout << "System with " << num_tasks << " tasks, best of " << repetitions << " loads" << endl;
+
+    string snapshot = string(filename) + ".snapshot";
+    ValidatingLoader vl;
+    unsigned long long hash;
+    systemdata::System *system = vl.load(filename);
+    bool ok = system && SystemSnapshot::hash_file(filename, hash) && SystemSnapshot::write(system, hash, snapshot);
+    delete system;
+
+    ok = ok && bench<SystemLoader>("DOM loader      ", filename, repetitions) &&
+               bench<StreamingSystemLoader>("Streaming loader", filename, repetitions) &&
+               bench<ValidatingLoader>("Stream+validate ", filename, repetitions) &&
+               bench<SnapshotLoader>("Snapshot        ", filename, repetitions);
+
+    unlink(filename);
+    unlink(snapshot.c_str());
+    return ok ? 0 : 1;
+}
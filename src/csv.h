@@ -0,0 +1,19 @@
+#ifndef CSV_H
+#define CSV_H
+
+#include <string>
+
+// Quotes a CSV field if it contains a separator, quote or line break
+inline std::string csv_field(const std::string &field) {
+    if (field.find_first_of(",\"\r\n") == std::string::npos) {
+        return field;
+    }
+    std::string quoted = "\"";
+    for (char c : field) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+#endif // CSV_H
@@ -0,0 +1,104 @@
+#include "edfqueue.h"
+
+void EDFQueue::place(int pos, const Entry &entry) {
+    heap[pos] = entry;
+    position[entry.index] = pos;
+}
+
+void EDFQueue::sift_up(int pos, Entry entry) {
+    while (pos > 0) {
+        int parent = (pos - 1) / arity;
+        if (!less(entry, heap[parent])) {
+            break;
+        }
+        place(pos, heap[parent]);
+        pos = parent;
+    }
+    place(pos, entry);
+}
+
+void EDFQueue::sift_down(int pos, Entry entry) {
+    int n = heap.size();
+    while (true) {
+        int first = pos * arity + 1;
+        if (first >= n) {
+            break;
+        }
+
+        // Find the smallest child
+        int last = first + arity < n ? first + arity : n;
+        int smallest = first;
+        for (int c = first + 1; c < last; c++) {
+            if (less(heap[c], heap[smallest])) {
+                smallest = c;
+            }
+        }
+
+        if (!less(heap[smallest], entry)) {
+            break;
+        }
+        place(pos, heap[smallest]);
+        pos = smallest;
+    }
+    place(pos, entry);
+}
+
+void EDFQueue::push(int index, int key) {
+    if (contains(index)) {
+        update(index, key);
+        return;
+    }
+
+    if (index >= static_cast<int>(position.size())) {
+        position.resize(index + 1, -1);
+    }
+
+    Entry entry = { key, index };
+    heap.push_back(entry);
+    sift_up(heap.size() - 1, entry);
+}
+
+void EDFQueue::pop() {
+    remove(heap[0].index);
+}
+
+void EDFQueue::update(int index, int key) {
+    int pos = position[index];
+    Entry entry = { key, index };
+    if (key < heap[pos].key) {
+        sift_up(pos, entry);
+    } else {
+        sift_down(pos, entry);
+    }
+}
+
+void EDFQueue::remove(int index) {
+    int pos = position[index];
+    position[index] = -1;
+
+    Entry last = heap.back();
+    heap.pop_back();
+    if (pos == static_cast<int>(heap.size())) {
+        return;
+    }
+
+    // Move the last entry into the hole, in whichever direction it has to go
+    if (pos > 0 && less(last, heap[(pos - 1) / arity])) {
+        sift_up(pos, last);
+    } else {
+        sift_down(pos, last);
+    }
+}
+
+void EDFQueue::clear() {
+    for (const auto &entry : heap) {
+        position[entry.index] = -1;
+    }
+    heap.clear();
+}
+
+void EDFQueue::shift_keys(int delta) {
+    for (auto &entry : heap) {
+        entry.key += delta;
+    }
+}
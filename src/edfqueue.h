@@ -0,0 +1,63 @@
+#ifndef EDFQUEUE_H
+#define EDFQUEUE_H
+
+#include <vector>
+
+// Indexed 4-ary min-heap used as ready/waiting queue by the EDF schedulers.
+// Entries are (key, index) pairs stored inline, where index is the position
+// of the task in its scheduler and key is e.g. the absolute deadline or the
+// release time, so sifting never has to look at the tasks themselves. Equal
+// keys are ordered by index, which keeps the schedule deterministic.
+class EDFQueue {
+    struct Entry {
+        int key;
+        int index;
+    };
+
+    static const int arity = 4;
+
+    std::vector<Entry> heap;
+    std::vector<int> position;      // Heap position for each index, -1 if not queued
+
+    static bool less(const Entry &x, const Entry &y) {
+        return x.key < y.key || (x.key == y.key && x.index < y.index);
+    }
+
+    void place(int pos, const Entry &entry);
+    void sift_up(int pos, Entry entry);
+    void sift_down(int pos, Entry entry);
+
+public:
+    bool empty() const {
+        return heap.empty();
+    }
+
+    int size() const {
+        return heap.size();
+    }
+
+    int top() const {
+        return heap[0].index;
+    }
+
+    int top_key() const {
+        return heap[0].key;
+    }
+
+    bool contains(int index) const {
+        return index < static_cast<int>(position.size()) && position[index] >= 0;
+    }
+
+    int key(int index) const {
+        return heap[position[index]].key;
+    }
+
+    void push(int index, int key);      // Updates the key if index is already queued
+    void pop();
+    void update(int index, int key);    // Decrease or increase the key of a queued index
+    void remove(int index);
+    void clear();
+    void shift_keys(int delta);         // Adds delta to all keys, which keeps the order
+};
+
+#endif // EDFQUEUE_H
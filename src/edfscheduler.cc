@@ -1,117 +1,115 @@
+#include <iostream>
 #include "edfscheduler.h"
-
-bool EDFScheduler::greater_start_time::operator()(Task *x, Task *y) const {
-    EDFSchedulerData *data_x = static_cast<EDFSchedulerData*>(x->get_taskdata());
-    EDFSchedulerData *data_y = static_cast<EDFSchedulerData*>(y->get_taskdata());
-    return data_x->release_time > data_y->release_time;
-}
-
-bool EDFScheduler::greater_deadline::operator()(Task *x, Task *y) const {
-    EDFSchedulerData *data_x = static_cast<EDFSchedulerData*>(x->get_taskdata());
-    EDFSchedulerData *data_y = static_cast<EDFSchedulerData*>(y->get_taskdata());
-    return data_x->abs_deadline > data_y->abs_deadline;
-}
-
+#include "releasequeue.h"
+using namespace std;
 
 EDFScheduler::EDFScheduler() {
     tick = 0;
-    running_task = NULL;
+    running_task = -1;
+    no_deadline_missed_warning = false;
 }
 
-void EDFScheduler::run() {
-    // Move tasks from waiting to ready queue if their release time has passed
-    while (!waiting_queue.empty()) {
-        Task *t = waiting_queue.top();
-        EDFSchedulerData *data = static_cast<EDFSchedulerData*>(t->get_taskdata());
-        if (data->release_time <= tick) {
-            waiting_queue.pop();
-            ready_queue.push(t);
-        } else {
-            break;
-        }
+void EDFScheduler::init() {
+    // All parameters are known now, so the tasks can be queued for their first release
+    for (auto d : data) {
+        release_queue->schedule(d->release_time, this, d->index);
     }
+}
 
+void EDFScheduler::run() {
     EDFSchedulerData *running_data = NULL;
-    Task *next_task = running_task;
+    int next_task = running_task;
 
-    if (running_task) {
-        running_data = static_cast<EDFSchedulerData*>(running_task->get_taskdata());
+    if (running_task >= 0) {
+        running_data = data[running_task];
     }
 
     // If the ready queue contains a task with an earlier deadline, force a swtch
     if (!ready_queue.empty()) {
         // New arrival with earlier deadline, switch
-        EDFSchedulerData *top_data = static_cast<EDFSchedulerData*>(ready_queue.top()->get_taskdata());
-        if (running_task && top_data->abs_deadline < running_data->abs_deadline) {
+        if (running_task >= 0 && ready_queue.top_key() < running_data->abs_deadline) {
             next_task = ready_queue.top();
             ready_queue.pop();
         }
     }
 
     // Try to switch tasks if the current task finished, or if the cpu is IDLE
-    if (next_task == running_task && ((running_task && running_data->ticks_remaining == 0) || !running_task)) {
+    if (next_task == running_task && ((running_task >= 0 && running_data->ticks_remaining == 0) || running_task < 0)) {
         // Task done, switch
         if (!ready_queue.empty()) {
             next_task = ready_queue.top();
             ready_queue.pop();
         } else {
             // IDLE
-            next_task = NULL;
+            next_task = -1;
         }
     }
 
     // Check for missed deadline
-    if (!no_deadline_missed_warning && running_task) {
+    if (!no_deadline_missed_warning && running_task >= 0) {
         if (running_data->ticks_remaining > 0 && running_data->abs_deadline <= tick) {
-            cout << "[" << tick << ":"<< get_name() << "]: Task '" << running_task->get_name() << " missed its deadline (" << running_data->abs_deadline << ", " << running_data->ticks_remaining << " ticks remaining)" << endl;
+            cout << "[" << tick << ":"<< get_name() << "]: Task '" << tasks[running_task]->get_name() << " missed its deadline (" << running_data->abs_deadline << ", " << running_data->ticks_remaining << " ticks remaining)" << endl;
             no_deadline_missed_warning = true;
         }
     }
 
     // Perform the actual task switch
     if (next_task != running_task) {
-        if (running_task && running_data->ticks_remaining == 0) {
+        if (running_task >= 0 && running_data->ticks_remaining == 0) {
             // Compute next release time
             running_data->release_time += running_data->period;
             running_data->abs_deadline = running_data->release_time + running_data->deadline;
-            if (running_data->release_time == tick) {       // Can resume immediately
-                next_task = running_task;
+            if (running_data->release_time == tick) {
+                // Can resume immediately, unless the task we picked has an earlier deadline
+                if (next_task < 0 || running_data->abs_deadline < data[next_task]->abs_deadline) {
+                    if (next_task >= 0) {
+                        ready_queue.push(next_task, data[next_task]->abs_deadline);
+                    }
+                    next_task = running_task;
+                } else {
+                    ready_queue.push(running_task, running_data->abs_deadline);
+                }
             } else {
-                waiting_queue.push(running_task);
+                release_queue->schedule(running_data->release_time, this, running_task);
             }
-        } else if (running_task) {
+        } else if (running_task >= 0) {
             // Task has not finished yet, return to ready queue
-            ready_queue.push(running_task);
+            ready_queue.push(running_task, running_data->abs_deadline);
         }
 
-        if (next_task) {
-            EDFSchedulerData *next_data = static_cast<EDFSchedulerData*>(next_task->get_taskdata());
+        if (next_task >= 0) {
+            EDFSchedulerData *next_data = data[next_task];
             if (next_data->ticks_remaining == 0) {
                 next_data->ticks_remaining = next_data->wcet;      // -1, since we already run in this tick without decrementing
             }
         }
 
 #if 0
-        if (running_task && next_task) {
-            cout << "[" << tick << ":" << get_name() << "]: Switch from '" << running_task->get_name() << "' to '" << next_task->get_name() << "'" << endl;
-        } else if (running_task) {
-            cout << "[" << tick << ":" << get_name() << "]: Switch from '" << running_task->get_name() << "' to IDLE" << endl;
-        } else if (next_task) {
-            cout << "[" << tick << ":" << get_name() << "]: Switch from IDLE to '" << next_task->get_name() << "'" << endl;
+        if (running_task >= 0 && next_task >= 0) {
+            cout << "[" << tick << ":" << get_name() << "]: Switch from '" << tasks[running_task]->get_name() << "' to '" << tasks[next_task]->get_name() << "'" << endl;
+        } else if (running_task >= 0) {
+            cout << "[" << tick << ":" << get_name() << "]: Switch from '" << tasks[running_task]->get_name() << "' to IDLE" << endl;
+        } else if (next_task >= 0) {
+            cout << "[" << tick << ":" << get_name() << "]: Switch from IDLE to '" << tasks[next_task]->get_name() << "'" << endl;
         }
 #endif
 
         no_deadline_missed_warning = false;
     }
     running_task = next_task;
-    if (running_task) {
-        running_data = static_cast<EDFSchedulerData*>(running_task->get_taskdata());
-    }
 
-    processors[0]->set_next(running_task);
-    if (running_task) {
+    // The task keeps the processor until it finishes, unless a release preempts it
+    int slice = 1;
+    if (running_task >= 0) {
+        running_data = data[running_task];
         running_data->ticks_remaining--;
+        slice = running_data->ticks_remaining + 1;
+        int next_release = release_queue->next_time();
+        if (next_release - tick < slice) {
+            slice = next_release - tick;
+        }
     }
+    processors[0]->set_next(running_task >= 0 ? tasks[running_task] : NULL, slice);
     tick++;
 }
 
@@ -119,9 +117,9 @@ void EDFScheduler::run() {
 void EDFScheduler::add_task(Task *task) {
     Scheduler::add_task(task);
     EDFSchedulerData *data = new EDFSchedulerData();
+    data->index = this->data.size();
     task->set_taskdata(data);
-
-    waiting_queue.push(task);
+    this->data.push_back(data);
 }
 
 void EDFScheduler::set_parameter(Task *task, SchedulingParameter param, const void *value) {
@@ -145,3 +143,58 @@ void EDFScheduler::set_parameter(Task *task, SchedulingParameter param, const vo
             break;
     }
 }
+
+void EDFScheduler::task_released(int index) {
+    ready_queue.push(index, data[index]->abs_deadline);
+}
+
+bool EDFScheduler::is_idle() const {
+    return running_task < 0 && ready_queue.empty();
+}
+
+void EDFScheduler::skip_ticks(int ticks) {
+    tick += ticks;
+}
+
+bool EDFScheduler::save_state(std::vector<int> &state) const {
+    state.push_back(running_task);
+    state.push_back(no_deadline_missed_warning);
+    for (auto d : data) {
+        state.push_back(d->release_time - tick);
+        state.push_back(d->abs_deadline - tick);
+        state.push_back(d->ticks_remaining);
+        state.push_back(ready_queue.contains(d->index));
+    }
+    return true;
+}
+
+bool EDFScheduler::restore_state(const std::vector<int> &state, int tick) {
+    int n = data.size();
+    if (static_cast<int>(state.size()) != 2 + 4 * n || state[0] < -1 || state[0] >= n) {
+        return false;
+    }
+
+    this->tick = tick;
+    running_task = state[0];
+    no_deadline_missed_warning = state[1];
+    ready_queue.clear();
+    for (int i = 0; i < n; i++) {
+        const int *s = &state[2 + 4 * i];
+        data[i]->release_time = s[0] + tick;
+        data[i]->abs_deadline = s[1] + tick;
+        data[i]->ticks_remaining = s[2];
+        if (s[3]) {
+            ready_queue.push(i, data[i]->abs_deadline);
+        }
+    }
+    return true;
+}
+
+void EDFScheduler::shift_time(int delta) {
+    tick += delta;
+    for (auto d : data) {
+        d->release_time += delta;
+        d->abs_deadline += delta;
+    }
+    ready_queue.shift_keys(delta);
+}
@@ -1,12 +1,13 @@
 #ifndef EDFSCHEDULER_H
 #define EDFSCHEDULER_H
 
-#include <queue>
 #include <vector>
 #include "scheduler.h"
+#include "edfqueue.h"
 
 class EDFSchedulerData : public TaskData {
     friend class EDFScheduler;
+    int index;              // Position in the scheduler's task list
     int start_time;
     int wcet;
     int period;
@@ -17,25 +18,24 @@ class EDFSchedulerData : public TaskData {
 };
 
 class EDFScheduler : public Scheduler {
-    struct greater_start_time {
-        bool operator()(Task *x, Task *y) const;
-    };
-
-    struct greater_deadline {
-        bool operator()(Task *x, Task *y) const;
-    };
-
-    std::priority_queue<Task*, std::vector<Task*>, greater_start_time> waiting_queue;
-    std::priority_queue<Task*, std::vector<Task*>, greater_deadline> ready_queue;
+    std::vector<EDFSchedulerData*> data;    // Indexed like tasks
+    EDFQueue ready_queue;                   // Keyed by absolute deadline
     int tick;
     int ticks_remaining;
-    Task *running_task;
+    int running_task;                       // Index of the running task, -1 if idle
     bool no_deadline_missed_warning;
 public:
     EDFScheduler();
+    void init();
     void run();
     void add_task(Task *task);
     void set_parameter(Task *task, SchedulingParameter param, const void *value);
+    void task_released(int index);
+    bool is_idle() const;
+    void skip_ticks(int ticks);
+    bool save_state(std::vector<int> &state) const;
+    void shift_time(int delta);
+    bool restore_state(const std::vector<int> &state, int tick);
 };
 
 #endif // EDFSCHEDULER_H
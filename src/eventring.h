@@ -0,0 +1,75 @@
+#ifndef EVENTRING_H
+#define EVENTRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for one producer thread and one consumer thread.
+// The consumer pops an element only after it is done with it, so an empty
+// ring means that everything pushed before has been handled.
+template <class T>
+class EventRing {
+    std::vector<T> buffer;
+    size_t mask;
+
+    // The indexes only grow; each is written by one side only and kept on its
+    // own cache line, together with that side's copy of the other index
+    char pad0[64];
+    std::atomic<size_t> head;       // Next element to push
+    size_t cached_tail;
+    char pad1[64];
+    std::atomic<size_t> tail;       // Next element to pop
+    size_t cached_head;
+    char pad2[64];
+
+public:
+    // The capacity is rounded up to a power of two
+    explicit EventRing(size_t capacity) : head(0), cached_tail(0), tail(0), cached_head(0) {
+        size_t size = 1;
+        while (size < capacity) size *= 2;
+        buffer.resize(size);
+        mask = size - 1;
+    }
+
+    EventRing(const EventRing&) = delete;
+    EventRing& operator=(const EventRing&) = delete;
+
+    // Producer: false if the ring is full
+    bool push(const T &element) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - cached_tail > mask) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (h - cached_tail > mask) {
+                return false;
+            }
+        }
+        buffer[h & mask] = element;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: oldest element, NULL if the ring is empty
+    const T *front() {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == cached_head) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (t == cached_head) {
+                return NULL;
+            }
+        }
+        return &buffer[t & mask];
+    }
+
+    // Consumer: removes the element returned by front()
+    void pop() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Producer: true once the consumer has popped everything pushed so far
+    bool empty() const {
+        return tail.load(std::memory_order_acquire) == head.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // EVENTRING_H
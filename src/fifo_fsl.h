@@ -8,10 +8,23 @@
 #define _FIFO_FSL_H_
 
 #include "systemc.h"
+#include "fsl_pipeline.h"
+#include <iterator>
+#include <utility>
+#include <vector>
 
 // Usage notes:
 // Each cycle only one read and one write operation are allowed. If data is read/written (that is, the operation doesn't block
 // on an empty or full FIFO), time is not advanced: advancing time should be done by the caller.
+// The read latency is the number of clock edges until a read frees its slot (exist/full), the write latency the number
+// of clock edges until a written token is in the buffer. Both are template parameters; make_fsl() picks them at run time.
+// read_n()/write_n() move several tokens in one operation. A burst of k tokens keeps the port busy for
+// ceil(k / bandwidth) cycles, which they return so the caller can advance time accordingly; all k tokens are accounted
+// and committed at once after the latency, so a burst costs one event instead of k.
+// Tokens are moved, not copied, through the FIFO: read()/read_n() move them out of the buffer, and write(T&&) and
+// write_n() on a non-const array move them in, leaving the caller's tokens moved-from. Only write(const T&) and
+// write_n() on a const array copy. For large payloads use fsl_token handles from an fsl_token_pool
+// (fsl_token_pool.h) as T, so only the handles go through the FIFO.
 
 // Set to nonzero to print FIFO operations
 //#define FIFO_VERBOSE 1
@@ -19,84 +32,106 @@
 // TODO: move to constructor of fifo? the user may want to set this from the command line
 const bool fail_on_blocking = true;
 
+// Common part of fsl and event_fsl: the buffer, the exist/full signals and the read/write interface.
 template <class T>
-SC_MODULE(fsl) , public sc_fifo<T> {
+SC_MODULE(fsl_base) , public sc_fifo<T> {
   public:
     sc_in<bool> clk;
 //     sc_in<bool> rst;
 
-    fsl(sc_module_name mn, int size);
-    fsl(sc_module_name mn, int size, sc_trace_file *tf);
-    //fsl(sc_module_name mn, int size, int rlatency, int wlatency);
-    ~fsl();
+    virtual ~fsl_base();
 
     sc_signal<bool> exist;
     sc_signal<bool> full;
 
     void read( T& );
     void write(const T&);
+    void write(T&&);
 
-    SC_HAS_PROCESS(fsl);
+    // Burst operations, return the number of cycles the port is busy
+    int read_n(T *vals, int n);
+    int write_n(const T *vals, int n);
+    int write_n(T *vals, int n);
+
+    // Tokens per cycle of a burst
+    void set_bandwidth(int bandwidth);
+    int get_bandwidth() const;
+
+  protected:
+    fsl_base(int size, sc_trace_file *tf);
+
+    // Pipelines of the derived FIFO, carrying the number of tokens of each operation
+    virtual void queue_read(int n) = 0;
+    virtual void queue_write(int n) = 0;
+
+    // Clock edge at which a read and/or a write of the given number of tokens come out of the pipelines
+    void clock_edge(int read, int written);
+
+    // True while a burst occupies one of the ports
+    bool busy() const;
 
   private:
-    void init(int size, sc_trace_file *tf);
-    void fsl_process();
+    int cycles(int n) const;
+    void take(T &val);
+    void commit(T &val);
+
+    // Shared by the copying and the moving writes
+    template <class Iter>
+    int stage_n(Iter vals, int n);
 
     sc_trace_file *tf;
-    int read_pending;
-    T read_val;
-    sc_event read_done;
-    bool *read_pipeline;
-    bool *write_pipeline;
-    T *read_queue;
-    T *write_queue;
-    int read_latency;     // Time between read call and return (simulates time to fetch data from buffer)
-    int write_latency;    // Time between write call and actual write into buffer; write() returns immediately if not blocking! Multiple writes in subsequent cycles are pipelined.
+    int bandwidth;
+    int read_busy;        // Clock edges until the read port is free again
+    int write_busy;       // Clock edges until the write port is free again
+    std::vector<T> staged;    // Written tokens that are not yet in the buffer (ring)
+    int staged_head;
+    int staged_count;
     int flen;             // Resembling fsl.fifo_length
     int max_tokens;       // Maximum number of tokens simultaneously in FIFO (collected during execution)
 };
 
 
-template <class T>
-fsl<T>::fsl(sc_module_name mn, int size) : sc_fifo<T> (size) {
-  init(size, NULL);
-}
+// Clocked FIFO: its process runs every clock edge.
+template <class T, int RL = 1, int WL = 1>
+class fsl : public fsl_base<T> {
+  public:
+    fsl(sc_module_name mn, int size, sc_trace_file *tf = NULL);
 
+    SC_HAS_PROCESS(fsl);
 
-template <class T>
-fsl<T>::fsl(sc_module_name mn, int size, sc_trace_file *tf) : sc_fifo<T> (size) {
-  init(size, tf);
-}
+  private:
+    void queue_read(int n) { read_pipeline.push(n); }
+    void queue_write(int n) { write_pipeline.push(n); }
+    void fsl_process();
 
+    fsl_pipeline<int, RL> read_pipeline;
+    fsl_pipeline<int, WL> write_pipeline;
+};
 
-template <class T>
-fsl<T>::~fsl() {
-  delete[] read_pipeline;
-  delete[] read_queue;
-  delete[] write_pipeline;
-  delete[] write_queue;
-  cout << sc_module::name() << ": Maximum number of tokens simultaneously in FIFO: " << max_tokens << endl;
-}
 
+// Event-driven variant of fsl with the same timing. Instead of running every
+// clock edge, the process only waits for the next edge while a read or write
+// is in its pipeline, and exist/full are only written when they change.
+template <class T, int RL = 1, int WL = 1>
+class event_fsl : public fsl_base<T> {
+  public:
+    event_fsl(sc_module_name mn, int size, sc_trace_file *tf = NULL);
 
-template <class T>
-void fsl<T>::init(int size, sc_trace_file *tf) {
-  read_pending = -1;
-  read_latency = 1;   // Values != 1 not tested
-  write_latency = 1;  // Values != 1 not tested
-  SC_CTHREAD(fsl_process, clk.pos());
-  this->read_pipeline = new bool[read_latency+1];
-  this->read_queue = new T[read_latency+1];
-  this->write_pipeline = new bool[write_latency+1];
-  this->write_queue = new T[write_latency+1];
+    SC_HAS_PROCESS(event_fsl);
+
+  private:
+    void queue_read(int n) { read_pipeline.push(n); pending.notify(SC_ZERO_TIME); }
+    void queue_write(int n) { write_pipeline.push(n); pending.notify(SC_ZERO_TIME); }
+    void fsl_process();
+
+    sc_event pending;     // Notified by read/write, so the process waits for the next clock edge
+    fsl_pipeline<int, RL> read_pipeline;
+    fsl_pipeline<int, WL> write_pipeline;
+};
 
-  for (int i = 0; i <= read_latency; i++) {
-    read_pipeline[i] = false;
-  }
-  for (int i = 0; i <= write_latency; i++) {
-    write_pipeline[i] = false;
-  }
 
+template <class T>
+fsl_base<T>::fsl_base(int size, sc_trace_file *tf) : sc_fifo<T> (size) {
   this->tf = tf;
   if (tf) {
     std::string sige("E");
@@ -109,6 +144,12 @@ void fsl<T>::init(int size, sc_trace_file *tf) {
     sc_trace(tf, full, sigf);
   }
 
+  bandwidth = 1;
+  read_busy = 0;
+  write_busy = 0;
+  staged.resize(size);
+  staged_head = 0;
+  staged_count = 0;
   flen = 0;
   exist.write(false);
   full.write(false);
@@ -117,15 +158,72 @@ void fsl<T>::init(int size, sc_trace_file *tf) {
 
 
 template <class T>
-void fsl<T>::read( T& val_ )
+fsl_base<T>::~fsl_base() {
+  cout << sc_module::name() << ": Maximum number of tokens simultaneously in FIFO: " << max_tokens << endl;
+}
+
+
+template <class T>
+void fsl_base<T>::set_bandwidth(int bandwidth) {
+  if (bandwidth < 1) {
+    cerr << "[" << sc_module::name() << "] Error: bandwidth should be >= 1" << endl;
+    exit(1);
+  }
+  this->bandwidth = bandwidth;
+}
+
+template <class T>
+int fsl_base<T>::get_bandwidth() const {
+  return bandwidth;
+}
+
+template <class T>
+int fsl_base<T>::cycles(int n) const {
+  return (n + bandwidth - 1) / bandwidth;
+}
+
+template <class T>
+bool fsl_base<T>::busy() const {
+  return read_busy > 0 || write_busy > 0;
+}
+
+// Like sc_fifo's buf_read()/buf_write(), but moving the token so no copy stays
+// behind in the buffer or the staging ring (which would keep a pooled slot alive)
+template <class T>
+void fsl_base<T>::take(T &val) {
+  val = std::move(this->m_buf[this->m_ri]);
+  this->m_ri = (this->m_ri + 1) % this->m_size;
+  this->m_free++;
+}
+
+template <class T>
+void fsl_base<T>::commit(T &val) {
+  this->m_buf[this->m_wi] = std::move(val);
+  this->m_wi = (this->m_wi + 1) % this->m_size;
+  this->m_free--;
+}
+
+
+template <class T>
+void fsl_base<T>::read( T& val_ )
 {
-  if (this->read_pending == 1) {
+  read_n(&val_, 1);
+}
+
+template <class T>
+int fsl_base<T>::read_n(T *vals, int n)
+{
+  if (read_busy > 0) {
     cerr << "[" << sc_module::name() << "] Error: more than one read during cycle " << sc_time_stamp() << endl;
     exit(1);
   }
+  if (n < 1 || n > this->m_size) {
+    cerr << "[" << sc_module::name() << "] Error: cannot read " << n << " tokens at once" << endl;
+    exit(1);
+  }
 
   // Block if empty
-  while( this->num_available() == 0 ) {
+  while( this->num_available() < n ) {
     if (fail_on_blocking) {
       cerr << sc_module::name() << ": Read at " << sc_time_stamp() << " blocked, aborting" << endl;
       exit(1);
@@ -136,28 +234,56 @@ void fsl<T>::read( T& val_ )
     sc_core::wait(1, SC_NS);
   }
 
-  // Do actual read in next clock cycle
-  this->read_pending = 1;//read_latency;
+  // Account the read after the read latency
+  read_busy = cycles(n);
+  queue_read(n);
 
-  this->m_num_read++;
-  this->buf_read(this->read_val);
+  for (int i = 0; i < n; i++) {
+    take(vals[i]);
+  }
+  this->m_num_read += n;
   this->request_update();
 
-  val_ = read_val;
+  return read_busy;
+}
+
+template <class T>
+void fsl_base<T>::write(const T& val) {
+  write_n(&val, 1);
 }
 
 template <class T>
-void fsl<T>::write(const T& val) {
+void fsl_base<T>::write(T&& val) {
+  write_n(&val, 1);
+}
+
+template <class T>
+int fsl_base<T>::write_n(const T *vals, int n) {
+  return stage_n(vals, n);
+}
+
+template <class T>
+int fsl_base<T>::write_n(T *vals, int n) {
+  return stage_n(std::make_move_iterator(vals), n);
+}
+
+template <class T>
+template <class Iter>
+int fsl_base<T>::stage_n(Iter vals, int n) {
 #ifdef FIFO_VERBOSE
   cout << "Write " << sc_module::name() << " at " << sc_time_stamp() << endl;
 #endif
-  if (write_pipeline[0] == true) {
+  if (write_busy > 0) {
     cerr << "[" << sc_module::name() << "] Error: more than one write during cycle " << sc_time_stamp() << endl;
     exit(1);
   }
+  if (n < 1 || n > this->m_size) {
+    cerr << "[" << sc_module::name() << "] Error: cannot write " << n << " tokens at once" << endl;
+    exit(1);
+  }
 
-  // Block if full
-  while (this->num_free() == 0) {
+  // Block if full, counting the tokens still in the write pipeline
+  while (this->num_free() - staged_count < n) {
     if (fail_on_blocking) {
       cerr << sc_module::name() << ": Write at " << sc_time_stamp() << " blocked, aborting" << endl;
       exit(1);
@@ -171,55 +297,133 @@ void fsl<T>::write(const T& val) {
   }
 
   // Queue the write operation
-  write_queue[0] = val;
-  write_pipeline[0] = true;
+  for (int i = 0; i < n; i++) {
+    staged[(staged_head + staged_count) % this->m_size] = *vals++;
+    staged_count++;
+  }
+  write_busy = cycles(n);
+  queue_write(n);
+
+  return write_busy;
 }
 
 
-// Clocked process
 template <class T>
-void fsl<T>::fsl_process() {
-  while (1) {
-    // Advance write queue:
-    for (int i = write_latency; i > 0; i--) {
-      write_pipeline[i] = write_pipeline[i-1];
-      write_queue[i] = write_queue[i-1];
-    }
-    write_pipeline[0] = false;
-
-    if (this->read_pending != 1  &&  write_pipeline[write_latency] == true  &&  full.read()==false) {
-      // write and no read: increment
-      flen++;
-    }
-    else if (this->read_pending == 1  &&  write_pipeline[write_latency] == false  &&  exist.read()==true) {
-      // read and no write: decrement
-      flen--;
-    }
+void fsl_base<T>::clock_edge(int read, int written) {
+  if (read_busy > 0)
+    read_busy--;
+  if (write_busy > 0)
+    write_busy--;
+
+  // Tokens that arrive while full or leave while empty are not counted
+  flen += written - read;
+  if (flen < 0)
+    flen = 0;
+  if (flen > this->m_size)
+    flen = this->m_size;
+  if (exist.read() != (flen != 0)) {
     exist.write(flen != 0);
+  }
+  if (full.read() != (flen == this->m_size)) {
     full.write(flen == this->m_size);
+  }
 
-    // Keep track of maximum number of tokens simultaneously in FIFO (which is the maximum buffersize for self-timed execution)
-    if (flen > max_tokens)
-      max_tokens = flen;
-
-    // Handle read
-    if (this->read_pending > 0) {
-      this->read_pending--;
-    }
+  // Keep track of maximum number of tokens simultaneously in FIFO (which is the maximum buffersize for self-timed execution)
+  if (flen > max_tokens)
+    max_tokens = flen;
 
-    if (write_pipeline[write_latency] == true) {
-      // A write is coming out of the queue, commit it:
+  if (written > 0) {
+    // A write is coming out of the queue, commit it:
 #ifdef FIFO_VERBOSE
-      cout << sc_module::name() << " committing write at " << sc_time_stamp() << endl;
+    cout << sc_module::name() << " committing write at " << sc_time_stamp() << endl;
 #endif
-      this->m_num_written++;
-      this->buf_write(write_queue[write_latency]);
-      this->request_update();
+    for (int i = 0; i < written; i++) {
+      commit(staged[staged_head]);
+      staged_head = (staged_head + 1) % this->m_size;
     }
+    staged_count -= written;
+    this->m_num_written += written;
+    this->request_update();
+  }
+}
+
+
+template <class T, int RL, int WL>
+fsl<T, RL, WL>::fsl(sc_module_name mn, int size, sc_trace_file *tf) : fsl_base<T> (size, tf) {
+  SC_CTHREAD(fsl_process, this->clk.pos());
+}
+
+
+// Clocked process
+template <class T, int RL, int WL>
+void fsl<T, RL, WL>::fsl_process() {
+  while (1) {
+    int written = 0;
+    int read = 0;
+    write_pipeline.advance(written);
+    read_pipeline.advance(read);
+    this->clock_edge(read, written);
 
     sc_core::wait();
   }
 }
 
 
+template <class T, int RL, int WL>
+event_fsl<T, RL, WL>::event_fsl(sc_module_name mn, int size, sc_trace_file *tf) : fsl_base<T> (size, tf) {
+  SC_METHOD(fsl_process);
+    this->sensitive << pending;
+    this->dont_initialize();
+}
+
+
+// Runs once per clock edge while an operation is in a pipeline or a burst occupies a port
+template <class T, int RL, int WL>
+void event_fsl<T, RL, WL>::fsl_process() {
+  // Notified between two clock edges: wait for the next one. An operation right
+  // at an edge is handled at that edge, like fsl's clocked process would.
+  if (!this->clk.posedge()) {
+    next_trigger(this->clk.posedge_event());
+    return;
+  }
+
+  int written = 0;
+  int read = 0;
+  write_pipeline.advance(written);
+  read_pipeline.advance(read);
+  this->clock_edge(read, written);
+
+  if (!read_pipeline.empty() || !write_pipeline.empty() || this->busy()) {
+    next_trigger(this->clk.posedge_event());
+  }
+}
+
+
+// Creates an fsl or event_fsl (F) with latencies that are only known at run
+// time, for example from the system XML.
+template <template <class, int, int> class F, class T, int RL>
+fsl_base<T>* make_fsl_write(const char *name, int size, int write_latency, sc_trace_file *tf) {
+  switch (write_latency) {
+    case 1: return new F<T, RL, 1>(name, size, tf);
+    case 2: return new F<T, RL, 2>(name, size, tf);
+    case 3: return new F<T, RL, 3>(name, size, tf);
+    case 4: return new F<T, RL, 4>(name, size, tf);
+  }
+  cerr << "Fatal error: write latency " << write_latency << " of fifo '" << name << "' not supported (at most " << fsl_max_latency << ")" << endl;
+  exit(1);
+}
+
+template <template <class, int, int> class F, class T>
+fsl_base<T>* make_fsl(const char *name, int size, int read_latency, int write_latency, sc_trace_file *tf = NULL) {
+  switch (read_latency) {
+    case 1: return make_fsl_write<F, T, 1>(name, size, write_latency, tf);
+    case 2: return make_fsl_write<F, T, 2>(name, size, write_latency, tf);
+    case 3: return make_fsl_write<F, T, 3>(name, size, write_latency, tf);
+    case 4: return make_fsl_write<F, T, 4>(name, size, write_latency, tf);
+  }
+  cerr << "Fatal error: read latency " << read_latency << " of fifo '" << name << "' not supported (at most " << fsl_max_latency << ")" << endl;
+  exit(1);
+}
+
+
 #endif
@@ -0,0 +1,128 @@
+#include "fpqueue.h"
+
+FPQueue::FPQueue() {
+    count = 0;
+    init(1);
+}
+
+void FPQueue::init(int levels) {
+    head.assign(levels, -1);
+    tail.assign(levels, -1);
+    next.clear();
+    prev.clear();
+    level_of.clear();
+    count = 0;
+
+    // Each bitmap level summarizes 64 words of the level below, up to a single word
+    bitmap.clear();
+    int bits = levels;
+    do {
+        int words = (bits + 63) / 64;
+        bitmap.push_back(std::vector<unsigned long long>(words, 0));
+        bits = words;
+    } while (bits > 1);
+}
+
+void FPQueue::set_bit(int level) {
+    for (auto &words : bitmap) {
+        bool was_empty = words[level / 64] == 0;
+        words[level / 64] |= 1ULL << (level % 64);
+        if (!was_empty) {
+            break;
+        }
+        level /= 64;
+    }
+}
+
+void FPQueue::clear_bit(int level) {
+    for (auto &words : bitmap) {
+        words[level / 64] &= ~(1ULL << (level % 64));
+        if (words[level / 64] != 0) {
+            break;
+        }
+        level /= 64;
+    }
+}
+
+int FPQueue::top_level() const {
+    // Walk down from the single top word, following the lowest set bit
+    int word = 0;
+    for (int b = bitmap.size() - 1; b > 0; b--) {
+        word = word * 64 + __builtin_ctzll(bitmap[b][word]);
+    }
+    return word * 64 + __builtin_ctzll(bitmap[0][word]);
+}
+
+void FPQueue::link(int index, int level, bool front) {
+    if (index >= static_cast<int>(level_of.size())) {
+        next.resize(index + 1, -1);
+        prev.resize(index + 1, -1);
+        level_of.resize(index + 1, -1);
+    }
+    if (level_of[index] >= 0) {
+        remove(index);
+    }
+
+    level_of[index] = level;
+    if (head[level] < 0) {
+        next[index] = prev[index] = -1;
+        head[level] = tail[level] = index;
+        set_bit(level);
+    } else if (front) {
+        prev[index] = -1;
+        next[index] = head[level];
+        prev[head[level]] = index;
+        head[level] = index;
+    } else {
+        next[index] = -1;
+        prev[index] = tail[level];
+        next[tail[level]] = index;
+        tail[level] = index;
+    }
+    count++;
+}
+
+void FPQueue::push_back(int index, int level) {
+    link(index, level, false);
+}
+
+void FPQueue::push_front(int index, int level) {
+    link(index, level, true);
+}
+
+void FPQueue::pop() {
+    remove(top());
+}
+
+void FPQueue::remove(int index) {
+    int level = level_of[index];
+
+    if (prev[index] >= 0) {
+        next[prev[index]] = next[index];
+    } else {
+        head[level] = next[index];
+    }
+    if (next[index] >= 0) {
+        prev[next[index]] = prev[index];
+    } else {
+        tail[level] = prev[index];
+    }
+
+    if (head[level] < 0) {
+        clear_bit(level);
+    }
+    level_of[index] = -1;
+    count--;
+}
+
+void FPQueue::clear() {
+    init(head.size());
+}
+
+void FPQueue::contents(std::vector<int> &indices) const {
+    for (int level = 0; level < static_cast<int>(head.size()); level++) {
+        for (int i = head[level]; i >= 0; i = next[i]) {
+            indices.push_back(i);
+        }
+    }
+}
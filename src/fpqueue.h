@@ -0,0 +1,54 @@
+#ifndef FPQUEUE_H
+#define FPQUEUE_H
+
+#include <vector>
+
+// Ready queue for the fixed-priority schedulers. Every priority level has its
+// own FIFO of task indices, and a hierarchy of 64-bit bitmaps records which
+// levels are non-empty, so the highest priority ready task is found with one
+// find-first-set per bitmap level, independent of the number of tasks.
+// Level 0 is the highest priority.
+class FPQueue {
+    std::vector<std::vector<unsigned long long> > bitmap;   // bitmap[0] has one bit per level
+    std::vector<int> head;          // First and last index per level, -1 if empty
+    std::vector<int> tail;
+    std::vector<int> next;          // Links per index
+    std::vector<int> prev;
+    std::vector<int> level_of;      // Level per index, -1 if not queued
+    int count;
+
+    void link(int index, int level, bool front);
+    void set_bit(int level);
+    void clear_bit(int level);
+
+public:
+    FPQueue();
+
+    void init(int levels);
+    bool empty() const {
+        return count == 0;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    int top() const {
+        return head[top_level()];
+    }
+
+    int top_level() const;
+
+    bool contains(int index) const {
+        return index < static_cast<int>(level_of.size()) && level_of[index] >= 0;
+    }
+
+    void push_back(int index, int level);       // Newly released tasks queue behind their level
+    void push_front(int index, int level);      // Preempted tasks resume first within their level
+    void pop();
+    void remove(int index);
+    void clear();
+    void contents(std::vector<int> &indices) const;     // In dequeue order
+};
+
+#endif // FPQUEUE_H
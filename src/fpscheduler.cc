@@ -0,0 +1,220 @@
+#include <iostream>
+#include <algorithm>
+#include "fpscheduler.h"
+#include "releasequeue.h"
+using namespace std;
+
+FPScheduler::FPScheduler() {
+    tick = 0;
+    running_task = -1;
+    no_deadline_missed_warning = false;
+}
+
+void FPScheduler::init() {
+    // Map the priorities onto dense levels, so the ready queue only needs one bit per distinct priority
+    vector<int> priorities;
+    for (auto d : data) {
+        priorities.push_back(d->priority);
+    }
+    sort(priorities.begin(), priorities.end());
+    priorities.erase(unique(priorities.begin(), priorities.end()), priorities.end());
+    for (auto d : data) {
+        d->level = lower_bound(priorities.begin(), priorities.end(), d->priority) - priorities.begin();
+    }
+    ready_queue.init(priorities.size() > 0 ? priorities.size() : 1);
+
+    // All parameters are set by now, whatever order they came in
+    for (auto d : data) {
+        d->abs_deadline = d->release_time + d->deadline;
+        release_queue->schedule(d->release_time, this, d->index);
+    }
+}
+
+void FPScheduler::run() {
+    // Tasks released in the same tick queue up in a fixed order, whatever order the release queue delivered them in
+    sort(released.begin(), released.end());
+    for (auto index : released) {
+        ready_queue.push_back(index, data[index]->level);
+    }
+    released.clear();
+
+    FPSchedulerData *running_data = NULL;
+    int next_task = running_task;
+
+    if (running_task >= 0) {
+        running_data = data[running_task];
+    }
+
+    // Preempt the running task if a task with a higher priority is ready
+    if (!ready_queue.empty()) {
+        if (running_task >= 0 && ready_queue.top_level() < running_data->level) {
+            next_task = ready_queue.top();
+            ready_queue.pop();
+        }
+    }
+
+    // Try to switch tasks if the current task finished, or if the cpu is IDLE
+    if (next_task == running_task && ((running_task >= 0 && running_data->ticks_remaining == 0) || running_task < 0)) {
+        if (!ready_queue.empty()) {
+            next_task = ready_queue.top();
+            ready_queue.pop();
+        } else {
+            next_task = -1;
+        }
+    }
+
+    // Check for missed deadline
+    if (!no_deadline_missed_warning && running_task >= 0) {
+        if (running_data->ticks_remaining > 0 && running_data->abs_deadline <= tick) {
+            cout << "[" << tick << ":"<< get_name() << "]: Task '" << tasks[running_task]->get_name() << " missed its deadline (" << running_data->abs_deadline << ", " << running_data->ticks_remaining << " ticks remaining)" << endl;
+            no_deadline_missed_warning = true;
+        }
+    }
+
+    // Perform the actual task switch
+    if (next_task != running_task) {
+        if (running_task >= 0 && running_data->ticks_remaining == 0) {
+            // Compute next release time
+            running_data->release_time += running_data->period;
+            running_data->abs_deadline = running_data->release_time + running_data->deadline;
+            if (running_data->release_time == tick) {
+                // Can resume immediately, unless the task we picked has a higher priority
+                if (next_task < 0 || running_data->level < data[next_task]->level) {
+                    if (next_task >= 0) {
+                        ready_queue.push_front(next_task, data[next_task]->level);
+                    }
+                    next_task = running_task;
+                } else {
+                    ready_queue.push_back(running_task, running_data->level);
+                }
+            } else {
+                release_queue->schedule(running_data->release_time, this, running_task);
+            }
+        } else if (running_task >= 0) {
+            // Preempted, resume before the other tasks of the same priority
+            ready_queue.push_front(running_task, running_data->level);
+        }
+
+        if (next_task >= 0) {
+            FPSchedulerData *next_data = data[next_task];
+            if (next_data->ticks_remaining == 0) {
+                next_data->ticks_remaining = next_data->wcet;
+            }
+        }
+
+        no_deadline_missed_warning = false;
+    }
+    running_task = next_task;
+
+    // The task keeps the processor until it finishes, unless a release preempts it
+    int slice = 1;
+    if (running_task >= 0) {
+        running_data = data[running_task];
+        running_data->ticks_remaining--;
+        slice = running_data->ticks_remaining + 1;
+        int next_release = release_queue->next_time();
+        if (next_release - tick < slice) {
+            slice = next_release - tick;
+        }
+    }
+    processors[0]->set_next(running_task >= 0 ? tasks[running_task] : NULL, slice);
+    tick++;
+}
+
+void FPScheduler::add_task(Task *task) {
+    Scheduler::add_task(task);
+    FPSchedulerData *data = new FPSchedulerData();
+    data->index = this->data.size();
+    task->set_taskdata(data);
+    this->data.push_back(data);
+}
+
+void FPScheduler::set_parameter(Task *task, SchedulingParameter param, const void *value) {
+    FPSchedulerData *data = static_cast<FPSchedulerData*>(task->get_taskdata());
+    switch (param) {
+        case PARAM_WCET:
+            data->wcet = *static_cast<const int*>(value);
+            break;
+        case PARAM_START_TIME:
+            data->start_time = *static_cast<const int*>(value);
+            data->release_time = data->start_time;
+            break;
+        case PARAM_PERIOD:
+            data->period = *static_cast<const int*>(value);
+            break;
+        case PARAM_DEADLINE:
+            data->deadline = *static_cast<const int*>(value);
+            break;
+        case PARAM_PRIORITY:
+            data->priority = *static_cast<const int*>(value);
+            break;
+        default:
+            break;
+    }
+}
+
+void FPScheduler::task_released(int index) {
+    released.push_back(index);
+}
+
+bool FPScheduler::is_idle() const {
+    return running_task < 0 && ready_queue.empty() && released.empty();
+}
+
+void FPScheduler::skip_ticks(int ticks) {
+    tick += ticks;
+}
+
+bool FPScheduler::save_state(std::vector<int> &state) const {
+    state.push_back(running_task);
+    state.push_back(no_deadline_missed_warning);
+    for (auto d : data) {
+        state.push_back(d->release_time - tick);
+        state.push_back(d->abs_deadline - tick);
+        state.push_back(d->ticks_remaining);
+    }
+
+    // The order within a priority level matters as well
+    std::vector<int> ready;
+    ready_queue.contents(ready);
+    state.push_back(ready.size());
+    state.insert(state.end(), ready.begin(), ready.end());
+    return true;
+}
+
+bool FPScheduler::restore_state(const std::vector<int> &state, int tick) {
+    int n = data.size();
+    if (static_cast<int>(state.size()) < 3 + 3 * n || state[0] < -1 || state[0] >= n
+            || static_cast<int>(state.size()) != 3 + 3 * n + state[2 + 3 * n]) {
+        return false;
+    }
+
+    this->tick = tick;
+    running_task = state[0];
+    no_deadline_missed_warning = state[1];
+    for (int i = 0; i < n; i++) {
+        const int *s = &state[2 + 3 * i];
+        data[i]->release_time = s[0] + tick;
+        data[i]->abs_deadline = s[1] + tick;
+        data[i]->ticks_remaining = s[2];
+    }
+
+    // Queue in the saved order to keep the FIFO order within each level
+    ready_queue.clear();
+    released.clear();
+    for (size_t i = 3 + 3 * n; i < state.size(); i++) {
+        if (state[i] < 0 || state[i] >= n) {
+            return false;
+        }
+        ready_queue.push_back(state[i], data[state[i]]->level);
+    }
+    return true;
+}
+
+void FPScheduler::shift_time(int delta) {
+    tick += delta;
+    for (auto d : data) {
+        d->release_time += delta;
+        d->abs_deadline += delta;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef FPSCHEDULER_H
+#define FPSCHEDULER_H
+
+#include <vector>
+#include "scheduler.h"
+#include "fpqueue.h"
+
+class FPSchedulerData : public TaskData {
+    friend class FPScheduler;
+    int index;              // Position in the scheduler's task list
+    int start_time;
+    int wcet;
+    int period;
+    int deadline;
+    int priority;           // Lower value means higher priority
+    int level;              // Dense priority level in the ready queue
+    int release_time;       // Absolute release time
+    int abs_deadline;       // Absolute deadline
+    int ticks_remaining;    // Ticks remaining for current period
+};
+
+// Partitioned fixed-priority preemptive scheduler (e.g. rate or deadline monotonic)
+class FPScheduler : public Scheduler {
+    std::vector<FPSchedulerData*> data;     // Indexed like tasks
+    FPQueue ready_queue;
+    std::vector<int> released;              // Released since the last run, queued in index order
+    int tick;
+    int running_task;                       // Index of the running task, -1 if idle
+    bool no_deadline_missed_warning;
+public:
+    FPScheduler();
+    void init();
+    void run();
+    void add_task(Task *task);
+    void set_parameter(Task *task, SchedulingParameter param, const void *value);
+    void task_released(int index);
+    bool is_idle() const;
+    void skip_ticks(int ticks);
+    bool save_state(std::vector<int> &state) const;
+    void shift_time(int delta);
+    bool restore_state(const std::vector<int> &state, int tick);
+};
+
+#endif // FPSCHEDULER_H
@@ -0,0 +1,61 @@
+#ifndef FSL_PIPELINE_H
+#define FSL_PIPELINE_H
+
+// Largest latency make_fsl() can instantiate
+const int fsl_max_latency = 4;
+
+// Delay line of an fsl FIFO: an item pushed between two clock edges comes out
+// L edges later, and every stage can hold one item. The stages live in a ring,
+// so a clock edge only moves the position of stage 0 instead of every item.
+template <class T, int L>
+class fsl_pipeline {
+    static_assert(L >= 1, "fsl latencies start at 1");
+
+    T values[L + 1];
+    bool valid[L + 1];
+    int head;           // Slot of stage 0, stage k is in slot (head + k) % (L + 1)
+    int count;          // Items that did not come out yet
+
+public:
+    fsl_pipeline() : head(0), count(0) {
+        for (int i = 0; i <= L; i++) {
+            valid[i] = false;
+        }
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    // True if an item was pushed since the last clock edge
+    bool pushed() const {
+        return valid[head];
+    }
+
+    void push(const T &value) {
+        values[head] = value;
+        valid[head] = true;
+        count++;
+    }
+
+    // Clock edge: moves every item one stage further, returns true if an item
+    // reached stage L
+    bool advance(T &value) {
+        head = head == 0 ? L : head - 1;
+        valid[head] = false;        // Came out at the previous edge
+
+        int last = head == 0 ? L : head - 1;
+        if (!valid[last]) {
+            return false;
+        }
+        value = values[last];
+        count--;
+        return true;
+    }
+};
+
+#endif // FSL_PIPELINE_H
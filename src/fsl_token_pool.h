@@ -0,0 +1,154 @@
+#ifndef FSL_TOKEN_POOL_H
+#define FSL_TOKEN_POOL_H
+
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// Pooled tokens for FIFOs with large payloads: the payloads live in slots of a
+// preallocated pool and the FIFO only carries fsl_token handles, e.g.
+// fsl<fsl_token<Frame> >. A slot is reclaimed when its last handle is released
+// or destroyed. The pool must outlive all of its handles.
+
+template <class P>
+class fsl_token_pool;
+
+template <class P>
+class fsl_token {
+    friend class fsl_token_pool<P>;
+
+    fsl_token_pool<P> *pool;
+    int slot;           // -1 for an empty handle
+
+    fsl_token(fsl_token_pool<P> *pool, int slot) : pool(pool), slot(slot) {}
+
+public:
+    fsl_token() : pool(NULL), slot(-1) {}
+
+    fsl_token(const fsl_token &other) : pool(other.pool), slot(other.slot) {
+        if (slot >= 0) {
+            pool->acquire(slot);
+        }
+    }
+
+    fsl_token(fsl_token &&other) : pool(other.pool), slot(other.slot) {
+        other.slot = -1;
+    }
+
+    fsl_token &operator=(const fsl_token &other) {
+        if (this != &other) {
+            release();
+            pool = other.pool;
+            slot = other.slot;
+            if (slot >= 0) {
+                pool->acquire(slot);
+            }
+        }
+        return *this;
+    }
+
+    fsl_token &operator=(fsl_token &&other) {
+        if (this != &other) {
+            release();
+            pool = other.pool;
+            slot = other.slot;
+            other.slot = -1;
+        }
+        return *this;
+    }
+
+    ~fsl_token() {
+        release();
+    }
+
+    // Drops this handle's reference, the handle is empty afterwards
+    void release() {
+        if (slot >= 0) {
+            pool->release(slot);
+            slot = -1;
+        }
+    }
+
+    explicit operator bool() const {
+        return slot >= 0;
+    }
+
+    P &operator*() const {
+        return pool->payload(slot);
+    }
+
+    P *operator->() const {
+        return &pool->payload(slot);
+    }
+
+    int get_slot() const {
+        return slot;
+    }
+};
+
+// Needed by sc_fifo's print()/dump()
+template <class P>
+std::ostream &operator<<(std::ostream &os, const fsl_token<P> &token) {
+    return os << "token(" << token.get_slot() << ")";
+}
+
+
+template <class P>
+class fsl_token_pool {
+    friend class fsl_token<P>;
+
+    std::vector<P> payloads;
+    std::vector<int> refs;          // Number of handles per slot
+    std::vector<int> free_slots;
+
+    void acquire(int slot) {
+        refs[slot]++;
+    }
+
+    void release(int slot) {
+        if (--refs[slot] == 0) {
+            free_slots.push_back(slot);
+        }
+    }
+
+    P &payload(int slot) {
+        return payloads[slot];
+    }
+
+public:
+    explicit fsl_token_pool(int slots) : payloads(slots), refs(slots, 0) {
+        free_slots.reserve(slots);
+        for (int i = slots - 1; i >= 0; i--) {
+            free_slots.push_back(i);
+        }
+    }
+
+    ~fsl_token_pool() {
+        if (available() != size()) {
+            std::cerr << "Warning: token pool destroyed with " << size() - available() << " slots in use" << std::endl;
+        }
+    }
+
+    // Handle to a free slot; the payload is not reset, the writer fills it in place
+    fsl_token<P> allocate() {
+        if (free_slots.empty()) {
+            std::cerr << "Fatal error: all " << size() << " slots of the token pool are in use" << std::endl;
+            exit(1);
+        }
+        int slot = free_slots.back();
+        free_slots.pop_back();
+        refs[slot] = 1;
+        return fsl_token<P>(this, slot);
+    }
+
+    int size() const {
+        return payloads.size();
+    }
+
+    int available() const {
+        return free_slots.size();
+    }
+};
+
+#endif // FSL_TOKEN_POOL_H
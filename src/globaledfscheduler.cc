@@ -1,49 +1,33 @@
+#include <iostream>
 #include "globaledfscheduler.h"
-
-bool GlobalEDFScheduler::greater_start_time::operator()(Task *x, Task *y) const {
-    GlobalEDFSchedulerData *data_x = static_cast<GlobalEDFSchedulerData*>(x->get_taskdata());
-    GlobalEDFSchedulerData *data_y = static_cast<GlobalEDFSchedulerData*>(y->get_taskdata());
-    return data_x->release_time > data_y->release_time;
-}
-
-bool GlobalEDFScheduler::greater_deadline::operator()(Task *x, Task *y) const {
-    GlobalEDFSchedulerData *data_x = static_cast<GlobalEDFSchedulerData*>(x->get_taskdata());
-    GlobalEDFSchedulerData *data_y = static_cast<GlobalEDFSchedulerData*>(y->get_taskdata());
-    return data_x->abs_deadline > data_y->abs_deadline;
-}
-
+#include "releasequeue.h"
+using namespace std;
 
 GlobalEDFScheduler::GlobalEDFScheduler() {
     tick = 0;
 }
 
-void GlobalEDFScheduler::run() {
-    // Move tasks from waiting to ready queue if their release time has passed
-    while (!waiting_queue.empty()) {
-        Task *t = waiting_queue.top();
-        GlobalEDFSchedulerData *data = static_cast<GlobalEDFSchedulerData*>(t->get_taskdata());
-        if (data->release_time <= tick) {
-            waiting_queue.pop();
-            ready_queue.push(t);
-        } else {
-            break;
-        }
+void GlobalEDFScheduler::init() {
+    // All parameters are known now, so the tasks can be queued for their first release
+    for (auto d : data) {
+        release_queue->schedule(d->release_time, this, d->index);
     }
+}
 
+void GlobalEDFScheduler::run() {
     // Check if current task has finished
     for (auto processor : processors) {
         Task *running_task = processor->get_current();
 
         if (running_task) {
             GlobalEDFSchedulerData *running_data = static_cast<GlobalEDFSchedulerData*>(running_task->get_taskdata());
-            running_data = static_cast<GlobalEDFSchedulerData*>(running_task->get_taskdata());
             if (running_data->ticks_remaining == 0) {
                 running_data->release_time += running_data->period;
                 running_data->abs_deadline = running_data->release_time + running_data->deadline;
                 if (running_data->release_time == tick) {
-                    ready_queue.push(running_task);
+                    ready_queue.push(running_data->index, running_data->abs_deadline);
                 } else {
-                    waiting_queue.push(running_task);
+                    release_queue->schedule(running_data->release_time, this, running_data->index);
                 }
             }
         }
@@ -71,14 +55,14 @@ void GlobalEDFScheduler::run() {
 
         // Try to find a task to run if it has an earlier deadline
         if (!ready_queue.empty()) {
-            GlobalEDFSchedulerData *top_data = static_cast<GlobalEDFSchedulerData*>(ready_queue.top()->get_taskdata());
+            Task *top_task = tasks[ready_queue.top()];
 
-            if ((running_task && top_data->abs_deadline < running_data->abs_deadline) || !running_task || running_task == ready_queue.top()) {
-                next_task = ready_queue.top();
+            if ((running_task && ready_queue.top_key() < running_data->abs_deadline) || !running_task || running_task == top_task) {
+                next_task = top_task;
                 ready_queue.pop();
                 if (running_task && running_task != next_task && running_data->ticks_remaining > 0) {
                     // Re-queue the previous task, as it has not finished yet, but only if we don't immediately re-schedule
-                    ready_queue.push(running_task);
+                    ready_queue.push(running_data->index, running_data->abs_deadline);
                 }
             }
         }
@@ -110,6 +94,26 @@ void GlobalEDFScheduler::run() {
         }
     }
 
+    // With an empty ready queue the allocation can only change when a task is
+    // released or one of the running tasks finishes, so grant a slice up to then
+    if (ready_queue.empty()) {
+        int slice = release_queue->next_time() - tick;
+        for (auto processor : processors) {
+            Task *next_task = processor->get_next();
+            if (next_task) {
+                int remaining = static_cast<GlobalEDFSchedulerData*>(next_task->get_taskdata())->ticks_remaining + 1;
+                if (remaining < slice) {
+                    slice = remaining;
+                }
+            }
+        }
+        for (auto processor : processors) {
+            if (processor->get_next()) {
+                processor->set_next(processor->get_next(), slice);
+            }
+        }
+    }
+
     tick++;
 }
 
@@ -117,9 +121,9 @@ void GlobalEDFScheduler::run() {
 void GlobalEDFScheduler::add_task(Task *task) {
     Scheduler::add_task(task);
     GlobalEDFSchedulerData *data = new GlobalEDFSchedulerData();
+    data->index = this->data.size();
     task->set_taskdata(data);
-
-    waiting_queue.push(task);
+    this->data.push_back(data);
 }
 
 void GlobalEDFScheduler::set_parameter(Task *task, SchedulingParameter param, const void *value) {
@@ -143,3 +147,63 @@ void GlobalEDFScheduler::set_parameter(Task *task, SchedulingParameter param, co
             break;
     }
 }
+
+void GlobalEDFScheduler::task_released(int index) {
+    ready_queue.push(index, data[index]->abs_deadline);
+}
+
+bool GlobalEDFScheduler::is_idle() const {
+    if (!ready_queue.empty()) {
+        return false;
+    }
+
+    for (auto processor : processors) {
+        if (processor->get_current()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void GlobalEDFScheduler::skip_ticks(int ticks) {
+    tick += ticks;
+}
+
+bool GlobalEDFScheduler::save_state(std::vector<int> &state) const {
+    for (auto d : data) {
+        state.push_back(d->release_time - tick);
+        state.push_back(d->abs_deadline - tick);
+        state.push_back(d->ticks_remaining);
+        state.push_back(ready_queue.contains(d->index));
+    }
+    return true;
+}
+
+bool GlobalEDFScheduler::restore_state(const std::vector<int> &state, int tick) {
+    if (state.size() != 4 * data.size()) {
+        return false;
+    }
+
+    this->tick = tick;
+    ready_queue.clear();
+    for (size_t i = 0; i < data.size(); i++) {
+        const int *s = &state[4 * i];
+        data[i]->release_time = s[0] + tick;
+        data[i]->abs_deadline = s[1] + tick;
+        data[i]->ticks_remaining = s[2];
+        if (s[3]) {
+            ready_queue.push(i, data[i]->abs_deadline);
+        }
+    }
+    return true;
+}
+
+void GlobalEDFScheduler::shift_time(int delta) {
+    tick += delta;
+    for (auto d : data) {
+        d->release_time += delta;
+        d->abs_deadline += delta;
+    }
+    ready_queue.shift_keys(delta);
+}
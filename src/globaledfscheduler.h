@@ -1,12 +1,13 @@
 #ifndef GLOBALEDFSCHEDULER_H
 #define GLOBALEDFSCHEDULER_H
 
-#include <queue>
 #include <vector>
 #include "scheduler.h"
+#include "edfqueue.h"
 
 class GlobalEDFSchedulerData : public TaskData {
     friend class GlobalEDFScheduler;
+    int index;              // Position in the scheduler's task list
     int start_time;
     int wcet;
     int period;
@@ -17,22 +18,21 @@ class GlobalEDFSchedulerData : public TaskData {
 };
 
 class GlobalEDFScheduler : public Scheduler {
-    struct greater_start_time {
-        bool operator()(Task *x, Task *y) const;
-    };
-
-    struct greater_deadline {
-        bool operator()(Task *x, Task *y) const;
-    };
-
-    std::priority_queue<Task*, std::vector<Task*>, greater_start_time> waiting_queue;
-    std::priority_queue<Task*, std::vector<Task*>, greater_deadline> ready_queue;
+    std::vector<GlobalEDFSchedulerData*> data;  // Indexed like tasks
+    EDFQueue ready_queue;                       // Keyed by absolute deadline
     int tick;
 public:
     GlobalEDFScheduler();
+    void init();
     void run();
     void add_task(Task *task);
     void set_parameter(Task *task, SchedulingParameter param, const void *value);
+    void task_released(int index);
+    bool is_idle() const;
+    void skip_ticks(int ticks);
+    bool save_state(std::vector<int> &state) const;
+    void shift_time(int delta);
+    bool restore_state(const std::vector<int> &state, int tick);
 };
 
 #endif // GLOBALEDFSCHEDULER_H
@@ -0,0 +1,231 @@
+#include <iostream>
+#include <algorithm>
+#include "globalfpscheduler.h"
+#include "releasequeue.h"
+using namespace std;
+
+GlobalFPScheduler::GlobalFPScheduler() {
+    tick = 0;
+}
+
+void GlobalFPScheduler::init() {
+    // Map the priorities onto dense levels, so the ready queue only needs one bit per distinct priority
+    vector<int> priorities;
+    for (auto d : data) {
+        priorities.push_back(d->priority);
+    }
+    sort(priorities.begin(), priorities.end());
+    priorities.erase(unique(priorities.begin(), priorities.end()), priorities.end());
+    for (auto d : data) {
+        d->level = lower_bound(priorities.begin(), priorities.end(), d->priority) - priorities.begin();
+    }
+    ready_queue.init(priorities.size() > 0 ? priorities.size() : 1);
+
+    // All parameters are set by now, whatever order they came in
+    for (auto d : data) {
+        d->abs_deadline = d->release_time + d->deadline;
+        release_queue->schedule(d->release_time, this, d->index);
+    }
+}
+
+void GlobalFPScheduler::run() {
+    // Tasks released in the same tick queue up in a fixed order, whatever order the release queue delivered them in
+    sort(released.begin(), released.end());
+    for (auto index : released) {
+        ready_queue.push_back(index, data[index]->level);
+    }
+    released.clear();
+
+    // Check if current task has finished
+    for (auto processor : processors) {
+        Task *running_task = processor->get_current();
+
+        if (running_task) {
+            GlobalFPSchedulerData *running_data = static_cast<GlobalFPSchedulerData*>(running_task->get_taskdata());
+            if (running_data->ticks_remaining == 0) {
+                running_data->release_time += running_data->period;
+                running_data->abs_deadline = running_data->release_time + running_data->deadline;
+                if (running_data->release_time == tick) {
+                    ready_queue.push_back(running_data->index, running_data->level);
+                } else {
+                    release_queue->schedule(running_data->release_time, this, running_data->index);
+                }
+            }
+        }
+    }
+
+    // Allocate tasks to processors
+    for (auto processor : processors) {
+        GlobalFPSchedulerData *running_data = NULL;
+        Task *running_task = processor->get_current();
+        Task *next_task = running_task;
+
+        if (running_task) {
+            running_data = static_cast<GlobalFPSchedulerData*>(running_task->get_taskdata());
+
+            // Check for missed deadline
+            if (running_data->ticks_remaining > 0 && running_data->abs_deadline <= tick) {
+                cout << "[" << tick << ":"<< get_name() << "]: Task '" << running_task->get_name() << " missed its deadline (" << running_data->abs_deadline << ", " << running_data->ticks_remaining << " ticks remaining)" << endl;
+            }
+        }
+
+        // Go IDLE if current task has finished
+        if (running_task && running_data->ticks_remaining == 0) {
+            next_task = NULL;
+        }
+
+        // Try to find a task to run if it has a higher priority
+        if (!ready_queue.empty()) {
+            Task *top_task = tasks[ready_queue.top()];
+
+            if ((running_task && ready_queue.top_level() < running_data->level) || !running_task || running_task == top_task) {
+                next_task = top_task;
+                ready_queue.pop();
+                if (running_task && running_task != next_task && running_data->ticks_remaining > 0) {
+                    // Re-queue the previous task, as it has not finished yet, ahead of the tasks with the same priority
+                    ready_queue.push_front(running_data->index, running_data->level);
+                }
+            }
+        }
+
+        if (next_task) {
+            GlobalFPSchedulerData *next_data = static_cast<GlobalFPSchedulerData*>(next_task->get_taskdata());
+            if (next_data->ticks_remaining == 0) {
+                next_data->ticks_remaining = next_data->wcet;
+            }
+        }
+
+        processor->set_next(next_task);
+        running_task = next_task;
+        if (running_task) {
+            running_data = static_cast<GlobalFPSchedulerData*>(running_task->get_taskdata());
+            running_data->ticks_remaining--;
+        }
+    }
+
+    // With an empty ready queue the allocation can only change when a task is
+    // released or one of the running tasks finishes, so grant a slice up to then
+    if (ready_queue.empty()) {
+        int slice = release_queue->next_time() - tick;
+        for (auto processor : processors) {
+            Task *next_task = processor->get_next();
+            if (next_task) {
+                int remaining = static_cast<GlobalFPSchedulerData*>(next_task->get_taskdata())->ticks_remaining + 1;
+                if (remaining < slice) {
+                    slice = remaining;
+                }
+            }
+        }
+        for (auto processor : processors) {
+            if (processor->get_next()) {
+                processor->set_next(processor->get_next(), slice);
+            }
+        }
+    }
+
+    tick++;
+}
+
+
+void GlobalFPScheduler::add_task(Task *task) {
+    Scheduler::add_task(task);
+    GlobalFPSchedulerData *data = new GlobalFPSchedulerData();
+    data->index = this->data.size();
+    task->set_taskdata(data);
+    this->data.push_back(data);
+}
+
+void GlobalFPScheduler::set_parameter(Task *task, SchedulingParameter param, const void *value) {
+    GlobalFPSchedulerData *data = static_cast<GlobalFPSchedulerData*>(task->get_taskdata());
+    switch (param) {
+        case PARAM_WCET:
+            data->wcet = *static_cast<const int*>(value);
+            break;
+        case PARAM_START_TIME:
+            data->start_time = *static_cast<const int*>(value);
+            data->release_time = data->start_time;
+            break;
+        case PARAM_PERIOD:
+            data->period = *static_cast<const int*>(value);
+            break;
+        case PARAM_DEADLINE:
+            data->deadline = *static_cast<const int*>(value);
+            break;
+        case PARAM_PRIORITY:
+            data->priority = *static_cast<const int*>(value);
+            break;
+        default:
+            break;
+    }
+}
+
+void GlobalFPScheduler::task_released(int index) {
+    released.push_back(index);
+}
+
+bool GlobalFPScheduler::is_idle() const {
+    if (!ready_queue.empty() || !released.empty()) {
+        return false;
+    }
+
+    for (auto processor : processors) {
+        if (processor->get_current()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void GlobalFPScheduler::skip_ticks(int ticks) {
+    tick += ticks;
+}
+
+bool GlobalFPScheduler::save_state(std::vector<int> &state) const {
+    for (auto d : data) {
+        state.push_back(d->release_time - tick);
+        state.push_back(d->abs_deadline - tick);
+        state.push_back(d->ticks_remaining);
+    }
+
+    // The order within a priority level matters as well
+    std::vector<int> ready;
+    ready_queue.contents(ready);
+    state.push_back(ready.size());
+    state.insert(state.end(), ready.begin(), ready.end());
+    return true;
+}
+
+bool GlobalFPScheduler::restore_state(const std::vector<int> &state, int tick) {
+    int n = data.size();
+    if (static_cast<int>(state.size()) < 1 + 3 * n || static_cast<int>(state.size()) != 1 + 3 * n + state[3 * n]) {
+        return false;
+    }
+
+    this->tick = tick;
+    for (int i = 0; i < n; i++) {
+        const int *s = &state[3 * i];
+        data[i]->release_time = s[0] + tick;
+        data[i]->abs_deadline = s[1] + tick;
+        data[i]->ticks_remaining = s[2];
+    }
+
+    // Queue in the saved order to keep the FIFO order within each level
+    ready_queue.clear();
+    released.clear();
+    for (size_t i = 1 + 3 * n; i < state.size(); i++) {
+        if (state[i] < 0 || state[i] >= n) {
+            return false;
+        }
+        ready_queue.push_back(state[i], data[state[i]]->level);
+    }
+    return true;
+}
+
+void GlobalFPScheduler::shift_time(int delta) {
+    tick += delta;
+    for (auto d : data) {
+        d->release_time += delta;
+        d->abs_deadline += delta;
+    }
+}
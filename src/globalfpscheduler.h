@@ -0,0 +1,42 @@
+#ifndef GLOBALFPSCHEDULER_H
+#define GLOBALFPSCHEDULER_H
+
+#include <vector>
+#include "scheduler.h"
+#include "fpqueue.h"
+
+class GlobalFPSchedulerData : public TaskData {
+    friend class GlobalFPScheduler;
+    int index;              // Position in the scheduler's task list
+    int start_time;
+    int wcet;
+    int period;
+    int deadline;
+    int priority;           // Lower value means higher priority
+    int level;              // Dense priority level in the ready queue
+    int release_time;       // Absolute release time
+    int abs_deadline;       // Absolute deadline
+    int ticks_remaining;    // Ticks remaining for current period
+};
+
+class GlobalFPScheduler : public Scheduler {
+    std::vector<GlobalFPSchedulerData*> data;  // Indexed like tasks
+    FPQueue ready_queue;
+    std::vector<int> released;                  // Released since the last run, queued in index order
+    int tick;
+public:
+    GlobalFPScheduler();
+    void init();
+    void run();
+    void add_task(Task *task);
+    void set_parameter(Task *task, SchedulingParameter param, const void *value);
+    void task_released(int index);
+    bool is_idle() const;
+    void skip_ticks(int ticks);
+    bool save_state(std::vector<int> &state) const;
+    void shift_time(int delta);
+    bool restore_state(const std::vector<int> &state, int tick);
+};
+
+#endif // GLOBALFPSCHEDULER_H
+
@@ -14,65 +14,78 @@ GraspMonitor::~GraspMonitor() {
     output.close();
 }
 
+GraspMonitor::TaskInfo& GraspMonitor::info(const Task *t) {
+    unsigned int id = t->get_id();
+    if (id >= task_data.size()) {
+        task_data.resize(id + 1);
+    }
+    task_data[id].task = t;
+    return task_data[id];
+}
+
 void GraspMonitor::add_processor(const Processor *p) {
-    output << "newProcessor " << p << " -name \"" << p->get_name() << "\"" << endl;
+    output << "newProcessor P" << p->get_id() << " -name \"" << p->get_name() << "\"" << endl;
 }
 
 void GraspMonitor::add_task(const Task *t) {
-    output << "newTask " << t << " -name \"" << t->get_name() << "\" -color " << colors[last_color] << endl;
+    info(t);
+    output << "newTask T" << t->get_id() << " -name \"" << t->get_name() << "\" -color " << colors[last_color] << endl;
     last_color = (last_color + 1) % (sizeof(colors) / sizeof(colors[0]));
 }
 
 void GraspMonitor::task_preempted(const Task *t, const Processor *p) {
-    task_data[t].et_current_period += get_time() - task_data[t].last_resume;
+    TaskInfo &ti = info(t);
+    ti.et_current_period += get_time() - ti.last_resume;
 
-    output << "plot " << get_time() << " jobPreempted " << t << ".0" << endl;
+    output << "plot " << get_time() << " jobPreempted T" << t->get_id() << ".0" << endl;
 
-    if (task_data[t].et_current_period >= task_data[t].wcet) {
-        output << "plot " << get_time() << " jobCompleted " << t << ".0" << endl;
+    if (ti.et_current_period >= ti.wcet) {
+        output << "plot " << get_time() << " jobCompleted T" << t->get_id() << ".0" << endl;
     }
 
-    task_data[t].last_preempt = get_time();
+    ti.last_preempt = get_time();
 }
 
 void GraspMonitor::task_resumed(const Task *t, const Processor *p) {
-    int period_no =  (get_time() - task_data[t].start_time) / task_data[t].period;
-    if (period_no != task_data[t].current_period) {
+    TaskInfo &ti = info(t);
+    int period_no =  (get_time() - ti.start_time) / ti.period;
+    if (period_no != ti.current_period) {
         // If we have not observed the task in its current period before, it released a new job
-        int start_time = period_no * task_data[t].period + task_data[t].start_time;
-        task_data[t].current_period = period_no;
-        task_data[t].et_current_period = 0;
-        output << "plot " << start_time << " jobArrived " << t << ".0" << " " << t << " -processor " << p << endl;
+        int start_time = period_no * ti.period + ti.start_time;
+        ti.current_period = period_no;
+        ti.et_current_period = 0;
+        output << "plot " << start_time << " jobArrived T" << t->get_id() << ".0" << " T" << t->get_id() << " -processor P" << p->get_id() << endl;
     }
 
-    output << "plot " << get_time() << " jobResumed " << t << ".0" << " -processor " << p << endl;
+    output << "plot " << get_time() << " jobResumed T" << t->get_id() << ".0" << " -processor P" << p->get_id() << endl;
 
-    task_data[t].last_resume = get_time();
-    task_data[t].processor = p;
+    ti.last_resume = get_time();
+    ti.processor = p;
 }
 
 void GraspMonitor::simulation_finished() {
     // Finish tasks that were still running at the end of the simulation
     for (auto &t : task_data) {
-        if (t.second.last_resume >= t.second.last_preempt && t.second.last_resume > 0) {      // we need to check >=, because a task might be preempted and resumed in the same cycle (migration)
-            task_preempted(t.first, t.second.processor);
+        if (t.last_resume >= t.last_preempt && t.last_resume > 0) {      // we need to check >=, because a task might be preempted and resumed in the same cycle (migration)
+            task_preempted(t.task, t.processor);
         }
     }
 }
 
 void GraspMonitor::set_parameter(const Task *task, SchedulingParameter param, const void *value) {
+    TaskInfo &ti = info(task);
     switch (param) {
         case PARAM_WCET:
-            task_data[task].wcet = *static_cast<const int*>(value);
+            ti.wcet = *static_cast<const int*>(value);
             break;
         case PARAM_DEADLINE:
-            task_data[task].deadline = *static_cast<const int*>(value);
+            ti.deadline = *static_cast<const int*>(value);
             break;
         case PARAM_PERIOD:
-            task_data[task].period = *static_cast<const int*>(value);
+            ti.period = *static_cast<const int*>(value);
             break;
         case PARAM_START_TIME:
-            task_data[task].start_time = *static_cast<const int*>(value);
+            ti.start_time = *static_cast<const int*>(value);
             break;
         default:
             break;
@@ -3,7 +3,7 @@
 
 #include <fstream>
 #include <string>
-#include <map>
+#include <vector>
 #include "monitor.h"
 
 class GraspMonitor : public Monitor {
@@ -17,16 +17,18 @@ class GraspMonitor : public Monitor {
         int last_preempt;
         int et_current_period;
         int color;
+        const Task *task;
         const Processor *processor;
 
     public:
         TaskInfo() : start_time(0), deadline(0), period(0),
                      current_period(-1), last_resume(-1),
                      last_preempt(-1), et_current_period(0),
-                     color(0), processor(NULL) {}
+                     color(0), task(NULL), processor(NULL) {}
     };
 
-    std::map<const Task*, TaskInfo> task_data;
+    std::vector<TaskInfo> task_data;        // Indexed by task id
+    TaskInfo& info(const Task *t);
     std::ofstream output;
     int last_color;
 public:
@@ -0,0 +1,294 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <unordered_map>
+#include "hybridedfscheduler.h"
+#include "releasequeue.h"
+using namespace std;
+
+HybridEDFScheduler::HybridEDFScheduler() {
+    tick = 0;
+}
+
+void HybridEDFScheduler::split_tasks() {
+    unordered_map<const Processor*, int> processor_index;
+    for (size_t p = 0; p < processors.size(); p++) {
+        processor_index[processors[p]] = p;
+    }
+    unordered_map<const Task*, int> task_index;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        task_index[tasks[i]] = i;
+    }
+
+    // Processors of each task, in mapping order
+    vector<vector<int> > task_processors(tasks.size());
+    for (auto ts : tasksets) {
+        auto p = processor_index.find(ts->get_processor());
+        if (p == processor_index.end()) continue;
+        for (auto task : ts->get_tasks()) {
+            auto i = task_index.find(task);
+            if (i != task_index.end()) {
+                task_processors[i->second].push_back(p->second);
+            }
+        }
+    }
+
+    vector<double> density(processors.size(), 0.0);
+
+    // Fixed tasks first, they determine the capacity left for the migrating ones
+    for (size_t i = 0; i < tasks.size(); i++) {
+        HybridEDFSchedulerData *d = data[i];
+        if (task_processors[i].empty()) {
+            cerr << "Fatal error: task '" << tasks[i]->get_name() << "' is not mapped onto a processor of scheduler '" << get_name() << "'" << endl;
+            exit(1);
+        }
+        if (d->migrating && task_processors[i].size() > 1) continue;
+
+        Portion portion = { static_cast<int>(i), task_processors[i][0], 0, d->deadline, d->wcet, -1, 0, 0 };
+        d->first_portion = portions.size();
+        portions.push_back(portion);
+        density[portion.processor] += static_cast<double>(d->wcet) / d->deadline;
+    }
+
+    // Split the migrating tasks into one portion per processor, in windows of D/n
+    for (size_t i = 0; i < tasks.size(); i++) {
+        HybridEDFSchedulerData *d = data[i];
+        if (!d->migrating || task_processors[i].size() <= 1) continue;
+
+        int n = task_processors[i].size();
+        int window = d->deadline / n;
+        int remaining = d->wcet;
+        int previous = -1;
+        for (int k = 0; k < n && remaining > 0; k++) {
+            int p = task_processors[i][k];
+            int offset = k * window;
+            int end = k == n - 1 ? d->deadline : offset + window;
+
+            int budget = static_cast<int>(floor((1.0 - density[p]) * (end - offset) + 1e-9));
+            if (budget < 0) {
+                budget = 0;
+            }
+            if (budget > remaining) {
+                budget = remaining;
+            }
+            if (k == n - 1 && budget < remaining) {
+                cerr << "Warning: migrating task '" << tasks[i]->get_name() << "' does not fit, its last portion overloads processor '" << processors[p]->get_name() << "'" << endl;
+                budget = remaining;
+            }
+            if (budget == 0) continue;
+
+            Portion portion = { static_cast<int>(i), p, offset, end, budget, -1, 0, 0 };
+            if (previous < 0) {
+                d->first_portion = portions.size();
+            } else {
+                portions[previous].next = portions.size();
+            }
+            previous = portions.size();
+            portions.push_back(portion);
+            density[p] += static_cast<double>(budget) / (end - offset);
+            remaining -= budget;
+        }
+    }
+}
+
+void HybridEDFScheduler::init() {
+    split_tasks();
+    cores.resize(processors.size());
+    for (auto &core : cores) {
+        core.running = -1;
+    }
+
+    for (auto d : data) {
+        release_portion(d->first_portion, d->release_time);
+    }
+}
+
+void HybridEDFScheduler::release_portion(int portion, int time) {
+    Portion &p = portions[portion];
+    p.ticks_remaining = p.budget;
+    p.abs_deadline = data[p.task]->release_time + p.window_end;
+    if (time <= tick) {
+        cores[p.processor].ready_queue.push(portion, p.abs_deadline);
+    } else {
+        release_queue->schedule(time, this, portion);
+    }
+}
+
+void HybridEDFScheduler::complete_portion(int portion) {
+    Portion &p = portions[portion];
+    HybridEDFSchedulerData *d = data[p.task];
+    if (p.next >= 0) {
+        // The next portion starts at its window, or now if we are already past it
+        int start = d->release_time + portions[p.next].offset;
+        release_portion(p.next, start > tick ? start : tick);
+    } else {
+        d->release_time += d->period;
+        d->abs_deadline = d->release_time + d->deadline;
+        d->deadline_missed_warning = false;
+        release_portion(d->first_portion, d->release_time);
+    }
+}
+
+void HybridEDFScheduler::run() {
+    // Finished portions first, as they may release a portion on another processor
+    for (auto &core : cores) {
+        if (core.running >= 0 && portions[core.running].ticks_remaining == 0) {
+            complete_portion(core.running);
+            core.running = -1;
+        }
+    }
+
+    // Local EDF on every processor
+    for (auto &core : cores) {
+        int running = core.running;
+        int next = running;
+
+        if (running >= 0) {
+            HybridEDFSchedulerData *d = data[portions[running].task];
+            if (!d->deadline_missed_warning && d->abs_deadline <= tick) {
+                cout << "[" << tick << ":"<< get_name() << "]: Task '" << tasks[portions[running].task]->get_name() << " missed its deadline (" << d->abs_deadline << ", " << portions[running].ticks_remaining << " ticks remaining)" << endl;
+                d->deadline_missed_warning = true;
+            }
+        }
+
+        if (!core.ready_queue.empty() && (running < 0 || core.ready_queue.top_key() < portions[running].abs_deadline)) {
+            next = core.ready_queue.top();
+            core.ready_queue.pop();
+            if (running >= 0) {
+                core.ready_queue.push(running, portions[running].abs_deadline);
+            }
+        }
+
+        core.running = next;
+        if (next >= 0) {
+            portions[next].ticks_remaining--;
+        }
+    }
+
+    // Nothing changes before the next release or the next portion completes on any processor
+    int slice = release_queue->next_time() - tick;
+    for (auto &core : cores) {
+        if (core.running >= 0 && portions[core.running].ticks_remaining + 1 < slice) {
+            slice = portions[core.running].ticks_remaining + 1;
+        }
+    }
+    for (size_t p = 0; p < processors.size(); p++) {
+        int running = cores[p].running;
+        processors[p]->set_next(running >= 0 ? tasks[portions[running].task] : NULL, slice);
+    }
+
+    tick++;
+}
+
+void HybridEDFScheduler::add_task(Task *task) {
+    Scheduler::add_task(task);
+    HybridEDFSchedulerData *data = new HybridEDFSchedulerData();
+    data->index = this->data.size();
+    task->set_taskdata(data);
+    this->data.push_back(data);
+}
+
+void HybridEDFScheduler::set_parameter(Task *task, SchedulingParameter param, const void *value) {
+    HybridEDFSchedulerData *data = static_cast<HybridEDFSchedulerData*>(task->get_taskdata());
+    switch (param) {
+        case PARAM_WCET:
+            data->wcet = *static_cast<const int*>(value);
+            break;
+        case PARAM_START_TIME:
+            data->start_time = *static_cast<const int*>(value);
+            data->release_time = data->start_time;
+            break;
+        case PARAM_PERIOD:
+            data->period = *static_cast<const int*>(value);
+            break;
+        case PARAM_DEADLINE:
+            data->deadline = *static_cast<const int*>(value);
+            data->abs_deadline = data->start_time + data->deadline;
+            break;
+        case PARAM_MIGRATING:
+            data->migrating = *static_cast<const int*>(value) != 0;
+            break;
+        default:
+            break;
+    }
+}
+
+void HybridEDFScheduler::task_released(int index) {
+    Portion &p = portions[index];
+    cores[p.processor].ready_queue.push(index, p.abs_deadline);
+}
+
+bool HybridEDFScheduler::is_idle() const {
+    for (auto &core : cores) {
+        if (core.running >= 0 || !core.ready_queue.empty()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void HybridEDFScheduler::skip_ticks(int ticks) {
+    tick += ticks;
+}
+
+bool HybridEDFScheduler::save_state(std::vector<int> &state) const {
+    for (auto &core : cores) {
+        state.push_back(core.running);
+    }
+    for (size_t i = 0; i < portions.size(); i++) {
+        state.push_back(portions[i].abs_deadline - tick);
+        state.push_back(portions[i].ticks_remaining);
+        state.push_back(cores[portions[i].processor].ready_queue.contains(i));
+    }
+    for (auto d : data) {
+        state.push_back(d->release_time - tick);
+        state.push_back(d->abs_deadline - tick);
+        state.push_back(d->deadline_missed_warning);
+    }
+    return true;
+}
+
+bool HybridEDFScheduler::restore_state(const std::vector<int> &state, int tick) {
+    int n = portions.size();
+    if (state.size() != cores.size() + 3 * portions.size() + 3 * data.size()) {
+        return false;
+    }
+
+    this->tick = tick;
+    size_t pos = 0;
+    for (auto &core : cores) {
+        core.running = state[pos++];
+        if (core.running < -1 || core.running >= n) {
+            return false;
+        }
+        core.ready_queue.clear();
+    }
+    for (int i = 0; i < n; i++) {
+        portions[i].abs_deadline = state[pos++] + tick;
+        portions[i].ticks_remaining = state[pos++];
+        if (state[pos++]) {
+            cores[portions[i].processor].ready_queue.push(i, portions[i].abs_deadline);
+        }
+    }
+    for (auto d : data) {
+        d->release_time = state[pos++] + tick;
+        d->abs_deadline = state[pos++] + tick;
+        d->deadline_missed_warning = state[pos++];
+    }
+    return true;
+}
+
+void HybridEDFScheduler::shift_time(int delta) {
+    tick += delta;
+    for (auto &portion : portions) {
+        portion.abs_deadline += delta;
+    }
+    for (auto &core : cores) {
+        core.ready_queue.shift_keys(delta);
+    }
+    for (auto d : data) {
+        d->release_time += delta;
+        d->abs_deadline += delta;
+    }
+}
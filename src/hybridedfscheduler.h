@@ -0,0 +1,69 @@
+#ifndef HYBRIDEDFSCHEDULER_H
+#define HYBRIDEDFSCHEDULER_H
+
+#include <vector>
+#include "scheduler.h"
+#include "edfqueue.h"
+
+class HybridEDFSchedulerData : public TaskData {
+    friend class HybridEDFScheduler;
+    int index;              // Position in the scheduler's task list
+    int start_time;
+    int wcet;
+    int period;
+    int deadline;
+    bool migrating;
+    int release_time;       // Absolute release time of the current job
+    int abs_deadline;       // Absolute deadline of the current job
+    int first_portion;      // First portion of the job
+    bool deadline_missed_warning;
+};
+
+// Semi-partitioned EDF (in the style of EDF-WM). Fixed tasks run on the
+// processor they are mapped to. A migrating task mapped to n processors is
+// split into n portions, each with a budget on one processor and a window of
+// D/n within the job's deadline. The budgets are computed once at init from
+// the density left on each processor, so at run time every processor runs
+// plain EDF on its own portions. Completing a portion releases the next one,
+// at the start of its window or right away if the window has started.
+class HybridEDFScheduler : public Scheduler {
+    struct Portion {
+        int task;           // Index of the task
+        int processor;      // Index in processors
+        int offset;         // Window start, relative to the job release
+        int window_end;     // Window end, relative to the job release
+        int budget;
+        int next;           // Next portion of the job, -1 for the last one
+        int abs_deadline;   // Absolute window end of the current job
+        int ticks_remaining;
+    };
+
+    struct Core {
+        EDFQueue ready_queue;       // Portions keyed by absolute window end
+        int running;                // Running portion, -1 if idle
+    };
+
+    std::vector<HybridEDFSchedulerData*> data;     // Indexed like tasks
+    std::vector<Portion> portions;
+    std::vector<Core> cores;                        // Indexed like processors
+    int tick;
+
+    void split_tasks();
+    void release_portion(int portion, int time);
+    void complete_portion(int portion);
+
+public:
+    HybridEDFScheduler();
+    void init();
+    void run();
+    void add_task(Task *task);
+    void set_parameter(Task *task, SchedulingParameter param, const void *value);
+    void task_released(int index);
+    bool is_idle() const;
+    void skip_ticks(int ticks);
+    bool save_state(std::vector<int> &state) const;
+    void shift_time(int delta);
+    bool restore_state(const std::vector<int> &state, int tick);
+};
+
+#endif // HYBRIDEDFSCHEDULER_H
@@ -11,9 +11,44 @@ int Monitor::get_time() const {
 Monitor::~Monitor() {
 }
 
-void Monitor::advance_time() {
-    time++;
+void Monitor::set_time(int time) {
+    this->time = time;
+}
+
+void Monitor::advance_time(int ticks) {
+    time += ticks;
 }
 
 void Monitor::set_parameter(const Task *task, SchedulingParameter param, const void *value) {
 }
+
+bool Monitor::can_extrapolate() const {
+    return false;
+}
+
+void Monitor::mark_period() {
+}
+
+void Monitor::extrapolate(int periods, int length) {
+}
+
+bool Monitor::save_state(std::vector<int> &state) const {
+    return false;
+}
+
+bool Monitor::restore_state(const std::vector<int> &state) {
+    return false;
+}
+
+int Monitor::get_num_sections() const {
+    return 1;
+}
+
+bool Monitor::save_sections(std::vector<std::vector<int> > &sections) const {
+    sections.push_back(std::vector<int>());
+    return save_state(sections.back());
+}
+
+bool Monitor::restore_sections(const std::vector<int> *sections, int tick) {
+    return restore_state(sections[0]);
+}
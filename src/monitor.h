@@ -1,6 +1,7 @@
 #ifndef MONITOR_H
 #define MONITOR_H
 
+#include <vector>
 #include "scheduler.h"
 
 class Processor;
@@ -10,16 +11,34 @@ class Monitor {
     int time;
 protected:
     int get_time() const;
+    void set_time(int time);
 public:
     Monitor();
     virtual ~Monitor();
-    void advance_time();
+    void advance_time(int ticks = 1);
     virtual void add_processor(const Processor *p) = 0;
     virtual void add_task(const Task *t) = 0;
     virtual void task_preempted(const Task *t, const Processor *p) = 0;
     virtual void task_resumed(const Task *t, const Processor *p) = 0;
     virtual void simulation_finished() = 0;
     virtual void set_parameter(const Task *task, SchedulingParameter param, const void *value);
+
+    // Steady-state support: once the schedule repeats, the figures gathered since
+    // the last mark are repeated for the given number of periods.
+    virtual bool can_extrapolate() const;
+    virtual void mark_period();
+    virtual void extrapolate(int periods, int length);
+
+    // Checkpoint support: saves and restores the accumulated figures and the time
+    virtual bool save_state(std::vector<int> &state) const;
+    virtual bool restore_state(const std::vector<int> &state);
+
+    // A checkpoint has a section with the state of each monitor. A monitor
+    // that wraps others has a section per wrapped monitor instead, so the
+    // checkpoint is the same as with those monitors registered directly.
+    virtual int get_num_sections() const;
+    virtual bool save_sections(std::vector<std::vector<int> > &sections) const;
+    virtual bool restore_sections(const std::vector<int> *sections, int tick);
 };
 
 #endif // MONITOR_H
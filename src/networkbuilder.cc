@@ -0,0 +1,67 @@
+#include "networkbuilder.h"
+#include "systembuilder.h"
+#include "sc_scheduler.h"
+#include "sc_csdf_actor.h"
+using namespace std;
+
+NetworkBuilder::NetworkBuilder(systemdata::System *system, SystemBuilder *builder, sc_scheduler *sched) {
+    this->system = system;
+    this->builder = builder;
+    this->sched = sched;
+}
+
+NetworkBuilder::~NetworkBuilder() {
+    for (auto actor : actors) {
+        delete actor;
+    }
+
+    // Fifos report their maximum number of tokens, in the order they were created
+    for (auto &name : fifo_names) {
+        delete fifos[name];
+    }
+
+    for (auto signal : running) {
+        delete signal;
+    }
+}
+
+fsl_base<int>* NetworkBuilder::get_fifo(const string &name, sc_clock &clk) {
+    auto f = fifos.find(name);
+    if (f != fifos.end()) {
+        return f->second;
+    }
+
+    const char *n = name.c_str();
+    fsl_base<int> *fifo = make_fsl<event_fsl, int>(n, builder->get_fifo_size(n, 16), builder->get_fifo_read_latency(n), builder->get_fifo_write_latency(n));
+    fifo->set_bandwidth(builder->get_fifo_bandwidth(n));
+    fifo->clk(clk);
+    fifos.insert(make_pair(name, fifo));
+    fifo_names.push_back(name);
+    return fifo;
+}
+
+void NetworkBuilder::build(sc_clock &clk, sc_trace_file *tf) {
+    for (auto a : system->get_actors()) {
+        string name = a->get_name();
+        sc_csdf_actor *actor = new sc_csdf_actor(name.c_str(), sched, a->get_num_phases());
+        builder->create_task(name, actor);
+        builder->set_delays(name.c_str(), actor);
+        actor->clk(clk);
+
+        sc_signal<bool> *signal = new sc_signal<bool>();
+        sc_trace(tf, *signal, name + "_running");
+        actor->running(*signal);
+
+        for (auto &port : a->get_ports()) {
+            fsl_base<int> *fifo = get_fifo(port.get_fifo_name(), clk);
+            if (port.get_direction() == systemdata::PORT_IN) {
+                actor->add_input(fifo, port.get_rates());
+            } else {
+                actor->add_output(fifo, port.get_rates());
+            }
+        }
+
+        actors.push_back(actor);
+        running.push_back(signal);
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef NETWORKBUILDER_H
+#define NETWORKBUILDER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <systemc.h>
+#include "system/systemdata.h"
+#include "fifo_fsl.h"
+
+class SystemBuilder;
+class sc_scheduler;
+class sc_csdf_actor;
+
+// Instantiates the actors and fifos of the system description as SystemC
+// modules and wires them together. SystemBuilder stays free of SystemC, so
+// this lives next to the simulator modules.
+class NetworkBuilder {
+    systemdata::System *system;
+    SystemBuilder *builder;
+    sc_scheduler *sched;
+    std::vector<std::string> fifo_names;                    // In creation order
+    std::unordered_map<std::string, fsl_base<int>*> fifos;
+    std::vector<sc_csdf_actor*> actors;
+    std::vector<sc_signal<bool>*> running;
+
+    fsl_base<int>* get_fifo(const std::string &name, sc_clock &clk);
+
+public:
+    NetworkBuilder(systemdata::System *system, SystemBuilder *builder, sc_scheduler *sched);
+    ~NetworkBuilder();
+
+    // Creates all actors and the fifos their ports refer to
+    void build(sc_clock &clk, sc_trace_file *tf);
+};
+
+#endif // NETWORKBUILDER_H
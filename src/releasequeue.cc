@@ -0,0 +1,173 @@
+#include <limits>
+#include "releasequeue.h"
+#include "scheduler.h"
+
+const int ReleaseQueue::never = std::numeric_limits<int>::max();
+
+ReleaseQueue::ReleaseQueue() {
+    now = -1;
+    clear();
+}
+
+// Times are biased so that their unsigned order matches the signed order
+static inline unsigned int wheel_key(int time) {
+    return static_cast<unsigned int>(time) ^ 0x80000000u;
+}
+
+int ReleaseQueue::new_event(int time, Scheduler *sched, int index) {
+    int e;
+    if (free_list >= 0) {
+        e = free_list;
+        free_list = events[e].next;
+    } else {
+        e = events.size();
+        events.push_back(Event());
+    }
+    events[e].time = time;
+    events[e].index = index;
+    events[e].sched = sched;
+    return e;
+}
+
+void ReleaseQueue::insert(int e) {
+    Event &event = events[e];
+    if (event.time <= now) {
+        event.next = due;
+        due = e;
+        return;
+    }
+
+    unsigned int key = wheel_key(event.time);
+    int level = (31 - __builtin_clz(key ^ wheel_key(now))) / level_bits;
+    int slot = (key >> (level * level_bits)) & (slots - 1);
+    event.next = slot_head[level][slot];
+    slot_head[level][slot] = e;
+    occupied[level] |= 1ULL << slot;
+}
+
+void ReleaseQueue::schedule(int time, Scheduler *sched, int index) {
+    insert(new_event(time, sched, index));
+    count++;
+}
+
+void ReleaseQueue::advance(int time) {
+    // Only events in the slot that contains the new time can change level, events
+    // in other slots of that level and on the levels above keep their place.
+    unsigned int key = wheel_key(time);
+    unsigned int diff = key ^ wheel_key(now);
+    now = time;
+    if (diff == 0) {
+        return;
+    }
+
+    int level = (31 - __builtin_clz(diff)) / level_bits;
+    int slot = (key >> (level * level_bits)) & (slots - 1);
+    int e = slot_head[level][slot];
+    slot_head[level][slot] = -1;
+    occupied[level] &= ~(1ULL << slot);
+    while (e >= 0) {
+        int next = events[e].next;
+        insert(e);
+        e = next;
+    }
+}
+
+void ReleaseQueue::deliver(int e) {
+    while (e >= 0) {
+        Event &event = events[e];
+        int next = event.next;
+        event.next = free_list;
+        free_list = e;
+        count--;
+        event.sched->task_released(event.index);
+        e = next;
+    }
+}
+
+void ReleaseQueue::expire(int time) {
+    // Moving the time to an event's time puts it on the due list
+    for (;;) {
+        if (due >= 0) {
+            int e = due;
+            due = -1;
+            deliver(e);
+        }
+        int t = next_time();
+        if (t > time || t == never) {
+            break;
+        }
+        advance(t);
+    }
+
+    if (time > now) {
+        advance(time);
+    }
+}
+
+int ReleaseQueue::next_time() const {
+    if (due >= 0) {
+        return now + 1;
+    }
+
+    // Events on lower levels are always earlier than those on higher levels, and
+    // all events in a level 0 slot share the same time
+    for (int level = 0; level < levels; level++) {
+        if (occupied[level]) {
+            int e = slot_head[level][__builtin_ctzll(occupied[level])];
+            int time = events[e].time;
+            if (level > 0) {
+                for (e = events[e].next; e >= 0; e = events[e].next) {
+                    if (events[e].time < time) {
+                        time = events[e].time;
+                    }
+                }
+            }
+            return time;
+        }
+    }
+
+    return never;
+}
+
+bool ReleaseQueue::empty() const {
+    return count == 0;
+}
+
+void ReleaseQueue::clear() {
+    events.clear();
+    free_list = -1;
+    due = -1;
+    count = 0;
+    for (int level = 0; level < levels; level++) {
+        occupied[level] = 0;
+        for (int slot = 0; slot < slots; slot++) {
+            slot_head[level][slot] = -1;
+        }
+    }
+}
+
+void ReleaseQueue::pending(std::vector<Pending> &list) const {
+    std::vector<int> heads(1, due);
+    for (int level = 0; level < levels; level++) {
+        for (int slot = 0; slot < slots; slot++) {
+            heads.push_back(slot_head[level][slot]);
+        }
+    }
+
+    for (auto head : heads) {
+        for (int e = head; e >= 0; e = events[e].next) {
+            Pending p = { events[e].time, events[e].sched, events[e].index };
+            list.push_back(p);
+        }
+    }
+}
+
+void ReleaseQueue::shift(int delta) {
+    std::vector<Pending> list;
+    pending(list);
+    clear();
+    now += delta;
+    for (auto &p : list) {
+        schedule(p.time + delta, p.sched, p.index);
+    }
+}
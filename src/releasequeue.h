@@ -0,0 +1,61 @@
+#ifndef RELEASEQUEUE_H
+#define RELEASEQUEUE_H
+
+#include <vector>
+
+class Scheduler;
+
+// Release events of all schedulers, kept in a hierarchical timing wheel.
+// Level l holds the events whose time first differs from the current time in
+// bit group l (6 bits per level), so inserting is O(1) and advancing the time
+// only has to move the events of a single slot one or more levels down.
+// Schedulers schedule (time, task index) events and get them back through
+// Scheduler::task_released() when the kernel expires the tick.
+class ReleaseQueue {
+    static const int level_bits = 6;
+    static const int slots = 1 << level_bits;
+    static const int levels = 6;
+
+    struct Event {
+        int time;
+        int index;
+        Scheduler *sched;
+        int next;           // Next event in the same slot, or free list
+    };
+
+    std::vector<Event> events;
+    int free_list;
+    int slot_head[levels][slots];
+    unsigned long long occupied[levels];    // Bitmap of non-empty slots per level
+    int due;                // Events scheduled at or before the current time
+    int now;                // Last expired tick
+    int count;
+
+    int new_event(int time, Scheduler *sched, int index);
+    void insert(int event);
+    void advance(int time);
+    void deliver(int head);
+
+public:
+    struct Pending {
+        int time;
+        Scheduler *sched;
+        int index;
+    };
+
+    static const int never;
+
+    ReleaseQueue();
+
+    void schedule(int time, Scheduler *sched, int index);
+    void expire(int time);      // Delivers all events up to and including time
+    int next_time() const;      // Earliest tick with pending events, or never
+    bool empty() const;
+    void clear();
+
+    // Steady-state support: list the pending events, and move them and the current time
+    void pending(std::vector<Pending> &list) const;
+    void shift(int delta);
+};
+
+#endif // RELEASEQUEUE_H
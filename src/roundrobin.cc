@@ -1,4 +1,6 @@
+#include <iostream>
 #include "roundrobin.h"
+using namespace std;
 
 RoundRobin::RoundRobin() {
 }
@@ -33,8 +35,10 @@ void RoundRobin::run() {
         }
 
         cout << "Running task: " << run_task->get_name() << " on processor " << p++ << endl;
-        static_cast<RoundRobinData*>(run_task->get_taskdata())->ticks--;
-        processor->set_next(run_task);
+        // The task keeps the processor for the rest of its quantum
+        RoundRobinData *data = static_cast<RoundRobinData*>(run_task->get_taskdata());
+        processor->set_next(run_task, data->ticks);
+        data->ticks--;
     }
 }
 
@@ -0,0 +1,38 @@
+#include <cstdlib>
+#include "sc_csdf_actor.h"
+
+sc_csdf_actor::sc_csdf_actor(const sc_module_name &name, sc_scheduler *sched, int num_phases) :
+    sc_csdf_actor_base(name, sched), num_phases(num_phases) {
+    SC_THREAD(run);
+        sensitive << clk.pos();
+}
+
+void sc_csdf_actor::add_port(std::vector<Port> &ports, fsl_base<int> *fifo, const std::vector<int> &rates) {
+    if (static_cast<int>(rates.size()) != num_phases) {
+        cerr << "Fatal error: port of actor '" << name() << "' needs " << num_phases << " rates" << endl;
+        exit(1);
+    }
+
+    Port port;
+    port.fifo = fifo;
+    port.rates = rates;
+    ports.push_back(port);
+
+    for (int rate : rates) {
+        if (rate > static_cast<int>(tokens.size())) {
+            tokens.resize(rate, 1);
+        }
+    }
+}
+
+void sc_csdf_actor::add_input(fsl_base<int> *fifo, const std::vector<int> &rates) {
+    add_port(inputs, fifo, rates);
+}
+
+void sc_csdf_actor::add_output(fsl_base<int> *fifo, const std::vector<int> &rates) {
+    add_port(outputs, fifo, rates);
+}
+
+void sc_csdf_actor::run() {
+    run_phases(num_phases, PortList(inputs), PortList(outputs), tokens.data());
+}
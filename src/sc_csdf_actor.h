@@ -0,0 +1,174 @@
+#ifndef SC_CSDF_ACTOR_H
+#define SC_CSDF_ACTOR_H
+
+#include <vector>
+#include <systemc.h>
+#include "sc_schedulable_module.h"
+#include "process.h"
+#include "fifo_fsl.h"
+
+// Common part of the cyclo-static dataflow actors. Each firing runs the next
+// phase: read the phase's number of tokens from every input fifo, execute,
+// and write the phase's number of tokens to every output fifo.
+class sc_csdf_actor_base : public sc_schedulable_module, public Process {
+protected:
+    sc_csdf_actor_base(const sc_module_name &name, sc_scheduler *sched) : sc_schedulable_module(name, sched) {}
+
+    // Fires the phases in turn, forever. In and Out give the ports of each
+    // direction: size(), fifo(i) and rate(i, phase), the tokens port i
+    // transfers in a phase. tokens is the burst buffer, sized for the
+    // largest rate.
+    template <class In, class Out>
+    void run_phases(int num_phases, const In &inputs, const Out &outputs, int *tokens);
+};
+
+template <class In, class Out>
+void sc_csdf_actor_base::run_phases(int num_phases, const In &inputs, const Out &outputs, int *tokens) {
+    // A burst keeps its ports busy for the cycles read_n()/write_n() return.
+    // The delays of the following phases count towards them, the actor only
+    // waits for what is left before it uses the ports again.
+    int now = 0;            // Ticks this actor ran
+    int inputs_free = 0;    // Tick from which the input ports can be read again
+    int outputs_free = 0;   // Tick from which the output ports can be written again
+
+    while (true) {
+        for (int phase = 0; phase < num_phases; phase++) {
+            wait_ticks(read_delay);
+            now += read_delay;
+            if (inputs_free > now) {
+                wait_ticks(inputs_free - now);
+                now = inputs_free;
+            }
+            for (int i = 0; i < inputs.size(); i++) {
+                if (inputs.rate(i, phase) > 0) {
+                    int busy = inputs.fifo(i)->read_n(tokens, inputs.rate(i, phase));
+                    if (now + busy > inputs_free) {
+                        inputs_free = now + busy;
+                    }
+                }
+            }
+
+            wait_ticks(exec_delay);
+            now += exec_delay;
+
+            wait_ticks(write_delay);
+            now += write_delay;
+            if (outputs_free > now) {
+                wait_ticks(outputs_free - now);
+                now = outputs_free;
+            }
+            for (int i = 0; i < outputs.size(); i++) {
+                if (outputs.rate(i, phase) > 0) {
+                    int busy = outputs.fifo(i)->write_n(tokens, outputs.rate(i, phase));
+                    if (now + busy > outputs_free) {
+                        outputs_free = now + busy;
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+// Generic cyclo-static dataflow actor, with its rates given at run time
+class sc_csdf_actor : public sc_csdf_actor_base {
+    struct Port {
+        fsl_base<int> *fifo;
+        std::vector<int> rates;     // Tokens per phase
+    };
+
+    // Ports of one direction, for run_phases()
+    class PortList {
+        const std::vector<Port> &ports;
+
+    public:
+        PortList(const std::vector<Port> &ports) : ports(ports) {}
+
+        int size() const {
+            return ports.size();
+        }
+
+        fsl_base<int> *fifo(int i) const {
+            return ports[i].fifo;
+        }
+
+        int rate(int i, int phase) const {
+            return ports[i].rates[phase];
+        }
+    };
+
+    int num_phases;
+    std::vector<Port> inputs;
+    std::vector<Port> outputs;
+    std::vector<int> tokens;        // Burst buffer, sized for the largest rate
+
+    void add_port(std::vector<Port> &ports, fsl_base<int> *fifo, const std::vector<int> &rates);
+    void run();
+
+public:
+    sc_in<bool> clk;
+
+    typedef sc_csdf_actor SC_CURRENT_USER_MODULE;
+    sc_csdf_actor(const sc_module_name &name, sc_scheduler *sched, int num_phases);
+
+    void add_input(fsl_base<int> *fifo, const std::vector<int> &rates);
+    void add_output(fsl_base<int> *fifo, const std::vector<int> &rates);
+};
+
+
+// sc_csdf_actor with its rate table known at compile time, as generated by
+// sysgen. R provides the constants phases, inputs, outputs and max_rate, and
+// the tables in[inputs][phases] and out[outputs][phases] (at least one row).
+template <class R>
+class sc_static_csdf_actor : public sc_csdf_actor_base {
+    // Ports of one direction, for run_phases(); the rates come from R::in or R::out
+    template <int N, bool input>
+    class PortTable {
+        fsl_base<int> *const *fifos;
+
+    public:
+        PortTable(fsl_base<int> *const *fifos) : fifos(fifos) {}
+
+        int size() const {
+            return N;
+        }
+
+        fsl_base<int> *fifo(int i) const {
+            return fifos[i];
+        }
+
+        int rate(int i, int phase) const {
+            return input ? R::in[i][phase] : R::out[i][phase];
+        }
+    };
+
+    fsl_base<int> *inputs[R::inputs > 0 ? R::inputs : 1];
+    fsl_base<int> *outputs[R::outputs > 0 ? R::outputs : 1];
+    int tokens[R::max_rate > 0 ? R::max_rate : 1];
+
+    void run() {
+        run_phases(R::phases, PortTable<R::inputs, true>(inputs), PortTable<R::outputs, false>(outputs), tokens);
+    }
+
+public:
+    sc_in<bool> clk;
+
+    typedef sc_static_csdf_actor SC_CURRENT_USER_MODULE;
+    sc_static_csdf_actor(const sc_module_name &name, sc_scheduler *sched) : sc_csdf_actor_base(name, sched) {
+        for (int i = 0; i < R::max_rate; i++) {
+            tokens[i] = 1;
+        }
+        SC_THREAD(run);
+            sensitive << clk.pos();
+    }
+
+    void bind_input(int i, fsl_base<int> &fifo) {
+        inputs[i] = &fifo;
+    }
+
+    void bind_output(int i, fsl_base<int> &fifo) {
+        outputs[i] = &fifo;
+    }
+};
+
+#endif // SC_CSDF_ACTOR_H
@@ -2,6 +2,7 @@
 #include "sc_scheduler.h"
 
 sc_schedulable_module::sc_schedulable_module(const sc_module_name& nm, sc_scheduler *sched) : sched(sched) {
+    task_id = -1;
 }
 
 void sc_schedulable_module::wait_ticks(int ticks) {
@@ -12,11 +13,16 @@ void sc_schedulable_module::wait_ticks(int ticks) {
         running.write(false);
         wait(sched->run_event(this));
 
-        // Simulate work
+        // Simulate work for the slice granted by the scheduler; it is only
+        // handed out for ticks in which the task cannot be preempted
+        int slice = sched->run_slice(this);
+        if (slice > total_ticks) {
+            slice = total_ticks;
+        }
         running.write(true);
-        wait(1, SC_NS);
+        wait(slice, SC_NS);
         running.write(false);
 
-        total_ticks--;
+        total_ticks -= slice;
     }
 }
@@ -6,7 +6,9 @@
 class sc_scheduler;    // forward declaration
 
 class sc_schedulable_module : public sc_module {
+    friend class sc_scheduler;
     sc_scheduler *sched;
+    int task_id;            // Set when the task is registered with the scheduler
 public:
     sc_out<bool> running;
     sc_schedulable_module(const sc_module_name& nm, sc_scheduler *sched);
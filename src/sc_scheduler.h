@@ -2,27 +2,21 @@
 #define SC_SCHEDULER_H
 
 #include <vector>
-#include <unordered_map>
 #include <systemc.h>
-#include "scheduler.h"
+#include "schedulingkernel.h"
 
 class sc_schedulable_module;
-class Monitor;
 
-class sc_scheduler : public sc_module {
+class sc_scheduler : public sc_module, public SchedulingKernel {
 private:
-    std::unordered_map<const sc_schedulable_module*, Task*> task_table;
-    std::vector<Task*> tasks;
-    std::vector<TaskSet*> tasksets;
-    std::vector<Processor*> processors;
-    std::vector<Monitor*> monitors;
-    std::vector<Scheduler*> schedulers;
-
-    int counter;
+    std::vector<Task*> task_table;          // Indexed by task id
+    std::vector<sc_event*> run_events;      // Indexed by task id
+
     sc_mutex m;
     sc_event preempt_event;
 
     void run();
+    void dispatch(Task *task);
 
 public:
     sc_in<bool> clk;
@@ -31,12 +25,10 @@ public:
     sc_scheduler(const sc_module_name &name);
     ~sc_scheduler();
 
-    void add_scheduler(Scheduler *sched);
     void add_task(Task *task);
-    void add_processor(Processor *processor);
-    void add_monitor(Monitor *monitor);
 
     sc_event& run_event(const sc_schedulable_module* mod);
+    int run_slice(const sc_schedulable_module* mod);
 };
 
 #endif // SC_SCHEDULER_H
@@ -0,0 +1,52 @@
+#include <iostream>
+#include "system/streamingsystemloader.h"
+#include "system/systemvalidator.h"
+#include "system/systemsnapshot.h"
+#include "schedsim_main.h"
+using namespace std;
+
+// Schedule-only counterpart of test.cc: simulates the scheduling decisions
+// for all tasks of a system without instantiating any SystemC processes.
+int main(int argc, char *argv[])
+{
+    StreamingSystemLoader sl;
+    SchedsimOptions options;
+
+    if (!parse_schedsim_options(argc, argv, true, options)) {
+        return schedsim_exit_usage;
+    }
+
+    // With -c, a snapshot of the validated system is loaded instead of the
+    // xml file, and written first if it is missing or out of date
+    systemdata::System* system = NULL;
+    unsigned long long source_hash = 0;
+    if (options.snapshot_file) {
+        if (!SystemSnapshot::hash_file(options.xml_file, source_hash)) {
+            return schedsim_exit_unreadable;
+        }
+        system = SystemSnapshot::load(options.snapshot_file, source_hash);
+    }
+
+    if (!system) {
+        system = sl.load(options.xml_file);
+        if (system) {
+            SystemValidator sv(system);
+            if (!sv.validate()) {
+                delete system;
+                return schedsim_exit_invalid;
+            }
+        } else {
+            cerr << sl.get_errors();
+            return schedsim_exit_unreadable;
+        }
+
+        // The snapshot only saves time, so failing to write it is not fatal
+        if (options.snapshot_file) {
+            SystemSnapshot::write(system, source_hash, options.snapshot_file);
+        }
+    }
+
+    int ret = run_schedsim(system, options);
+    delete system;
+    return ret;
+}
@@ -0,0 +1,182 @@
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <climits>
+#include <unistd.h>
+#include "system/schedulabilityanalysis.h"
+#include "systembuilder.h"
+#include "schedulesimulator.h"
+#include "statsmonitor.h"
+#include "graspmonitor.h"
+#include "asyncmonitor.h"
+#include "schedsim_main.h"
+using namespace std;
+
+static void usage(const char *name, bool with_file) {
+    if (with_file) {
+        cerr << "Usage: " << name << " [-s stats-file] [-a] [-f] [-e] [-r checkpoint] [-w checkpoint] [-c snapshot] [-t] <xml-file> [simulation-time]" << endl;
+    } else {
+        cerr << "Usage: " << name << " [-s stats-file] [-a] [-f] [-e] [-r checkpoint] [-w checkpoint] [-t] [simulation-time]" << endl;
+    }
+}
+
+bool parse_schedsim_options(int argc, char *argv[], bool with_file, SchedsimOptions &options) {
+    options.xml_file = NULL;
+    options.simulation_time = -1;
+    options.stats_file = NULL;
+    options.checkpoint_in = NULL;
+    options.checkpoint_out = NULL;
+    options.snapshot_file = NULL;
+    options.analyse = options.filter = options.steady = options.threaded = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, with_file ? "s:afer:w:c:t" : "s:afer:w:t")) != -1) {
+        switch (opt) {
+            case 's':
+                options.stats_file = optarg;
+                break;
+            case 'a':
+                options.analyse = true;
+                break;
+            case 'f':
+                options.analyse = options.filter = true;
+                break;
+            case 'e':
+                options.steady = true;
+                break;
+            case 'r':
+                options.checkpoint_in = optarg;
+                break;
+            case 'w':
+                options.checkpoint_out = optarg;
+                break;
+            case 'c':
+                options.snapshot_file = optarg;
+                break;
+            case 't':
+                options.threaded = true;
+                break;
+            default:
+                usage(argv[0], with_file);
+                return false;
+        }
+    }
+
+    int files = with_file ? 1 : 0;
+    if (argc - optind < files || argc - optind > files + 1) {
+        usage(argv[0], with_file);
+        return false;
+    }
+    if (with_file) {
+        options.xml_file = argv[optind];
+    }
+    if (argc - optind == files + 1) {
+        options.simulation_time = atoi(argv[optind + files]);
+    }
+    return true;
+}
+
+int run_schedsim(systemdata::System *system, const SchedsimOptions &options) {
+    // Schedulability analysis, with -f infeasible systems are not simulated
+    if (options.analyse) {
+        SchedulabilityAnalysis sa(system);
+        bool infeasible = false;
+        for (auto &r : sa.analyse()) {
+            cout << "Processor '" << r.processor << "' (scheduler '" << r.scheduler << "'): "
+                 << SchedulabilityAnalysis::verdict_name(r.verdict) << " by " << r.test
+                 << " (" << r.time_us << " us)" << endl;
+            infeasible = infeasible || r.verdict == SchedulabilityAnalysis::INFEASIBLE;
+        }
+        if (options.filter && infeasible) {
+            cout << "System is not schedulable, skipping simulation" << endl;
+            return schedsim_exit_infeasible;
+        }
+    }
+
+    // A trace cannot be extrapolated or continued, so with -e, -r and -w only
+    // statistics are gathered
+    StatsMonitor statsmon;
+    GraspMonitor *graspmon = options.steady || options.checkpoint_in || options.checkpoint_out ? NULL : new GraspMonitor("trace.grasp");
+
+    // With -t, the monitors run on a thread of their own and the simulation
+    // only queues the task switches for them. Checkpoints are the same either
+    // way.
+    AsyncMonitor *asyncmon = options.threaded ? new AsyncMonitor() : NULL;
+
+    ScheduleSimulator sim;
+    if (asyncmon) {
+        asyncmon->add_monitor(&statsmon);
+        if (graspmon) asyncmon->add_monitor(graspmon);
+        sim.add_monitor(asyncmon);
+    } else {
+        sim.add_monitor(&statsmon);
+        if (graspmon) sim.add_monitor(graspmon);
+    }
+
+    SystemBuilder sb(system, &sim);
+    sb.create_tasks();
+
+    if (asyncmon) {
+        sb.set_monitoring_parameters(asyncmon);
+    } else {
+        if (graspmon) sb.set_monitoring_parameters(graspmon);
+        sb.set_monitoring_parameters(&statsmon);
+    }
+
+    int simulation_time = options.simulation_time;
+    if (simulation_time == -1) {
+        simulation_time = sb.get_default_simulation_time();
+    }
+    if (options.checkpoint_in) {
+        if (!sim.read_checkpoint(options.checkpoint_in)) {
+            delete asyncmon;
+            delete graspmon;
+            return schedsim_exit_checkpoint;
+        }
+        if (simulation_time <= sim.get_tick()) {
+            cerr << "Error: checkpoint '" << options.checkpoint_in << "' is at tick " << sim.get_tick()
+                 << ", the simulation time must be after it" << endl;
+            delete asyncmon;
+            delete graspmon;
+            return schedsim_exit_checkpoint;
+        }
+        cout << "Resuming from checkpoint '" << options.checkpoint_in << "'" << endl;
+    }
+    cout << "Running schedule-only simulation for " << simulation_time << " clock cycles" << endl;
+    sim.enable_fast_forward(simulation_time);
+
+    // After all tasks started the schedule can only repeat with the hyperperiod
+    if (options.steady) {
+        if (sb.get_hyperperiod() <= INT_MAX) {
+            sim.enable_steady_state_detection(sb.get_max_start_time() > 0 ? sb.get_max_start_time() : 0,
+                                              static_cast<int>(sb.get_hyperperiod()));
+        } else {
+            cerr << "Warning: hyperperiod too large for steady-state detection" << endl;
+        }
+    }
+
+    sim.run(simulation_time);
+
+    // Written before the monitors account for the tasks still running
+    if (options.checkpoint_out && !sim.write_checkpoint(options.checkpoint_out)) {
+        delete asyncmon;
+        delete graspmon;
+        return schedsim_exit_checkpoint;
+    }
+
+    if (asyncmon) {
+        asyncmon->simulation_finished();
+        delete asyncmon;
+    } else {
+        if (graspmon) graspmon->simulation_finished();
+        statsmon.simulation_finished();
+    }
+    delete graspmon;
+    statsmon.write_stats(cerr);
+    if (options.stats_file) {
+        ofstream stats(options.stats_file);
+        statsmon.write_stats_csv(stats);
+    }
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef SCHEDSIM_MAIN_H
+#define SCHEDSIM_MAIN_H
+
+#include "system/systemdata.h"
+
+// Exit statuses of schedsim and the generated simulators, besides 0
+const int schedsim_exit_usage = -1;
+const int schedsim_exit_invalid = -2;       // The system fails validation
+const int schedsim_exit_unreadable = -3;    // The system file cannot be loaded
+const int schedsim_exit_checkpoint = -4;    // A checkpoint cannot be read or written
+const int schedsim_exit_infeasible = 3;     // -f found the system infeasible, distinct
+                                            // from the exit(1) of fatal errors
+
+// Command line driver of the schedule-only simulator, shared by schedsim.cc
+// and the simulators that sysgen generates for one system. Those have the
+// system built in, so they take no xml file and no snapshot.
+struct SchedsimOptions {
+    const char *xml_file;           // NULL if the system is built in
+    int simulation_time;            // -1 for the default
+    const char *stats_file;
+    const char *checkpoint_in;
+    const char *checkpoint_out;
+    const char *snapshot_file;
+    bool analyse;
+    bool filter;
+    bool steady;
+    bool threaded;
+};
+
+// Parses the options and arguments, with_file if an xml file comes before the
+// simulation time. Prints the usage and returns false if they are invalid.
+bool parse_schedsim_options(int argc, char *argv[], bool with_file, SchedsimOptions &options);
+
+// Analyses and simulates a validated system as the options ask for, returns
+// the exit status of the simulator
+int run_schedsim(systemdata::System *system, const SchedsimOptions &options);
+
+#endif // SCHEDSIM_MAIN_H
@@ -1,7 +1,10 @@
 #include <algorithm>
 #include <string>
 #include "scheduler.h"
-#include "sc_schedulable_module.h"
+
+Scheduler::Scheduler() {
+    release_queue = NULL;
+}
 
 void Scheduler::set_name(const std::string &name) {
     this->name = name;
@@ -29,8 +32,35 @@ void Scheduler::set_parameter(Task *task, SchedulingParameter param, const void
 void Scheduler::init() {
 }
 
-void Processor::set_next(Task *task) {
+void Scheduler::set_release_queue(ReleaseQueue *queue) {
+    release_queue = queue;
+}
+
+void Scheduler::task_released(int index) {
+}
+
+bool Scheduler::is_idle() const {
+    // Schedulers that cannot predict their next release are never skipped
+    return false;
+}
+
+void Scheduler::skip_ticks(int ticks) {
+}
+
+bool Scheduler::save_state(std::vector<int> &state) const {
+    return false;
+}
+
+void Scheduler::shift_time(int delta) {
+}
+
+bool Scheduler::restore_state(const std::vector<int> &state, int tick) {
+    return false;
+}
+
+void Processor::set_next(Task *task, int slice) {
     next = task;
+    next_slice = slice;
 }
 
 void Processor::set_name(const std::string &name) {
@@ -41,6 +71,14 @@ std::string Processor::get_name() const {
     return name;
 }
 
+void Processor::set_id(int id) {
+    this->id = id;
+}
+
+int Processor::get_id() const {
+    return id;
+}
+
 Task* Processor::get_previous() const {
     return previous;
 }
@@ -54,11 +92,16 @@ Task* Processor::get_next() const {
 }
 
 Task::Task() {
+    id = -1;
     module = NULL;
+    slice = 1;
     taskdata = NULL;
 }
 
-Task::Task(const sc_schedulable_module *module) : module(module) {
+Task::Task(const std::string &name) : name(name) {
+    id = -1;
+    module = NULL;
+    slice = 1;
     taskdata = NULL;
 }
 
@@ -66,7 +109,19 @@ Task::~Task() {
     delete taskdata;
 }
 
-void Task::set_module(const sc_schedulable_module *module) {
+void Task::set_name(const std::string &name) {
+    this->name = name;
+}
+
+void Task::set_id(int id) {
+    this->id = id;
+}
+
+int Task::get_id() const {
+    return id;
+}
+
+void Task::set_module(sc_schedulable_module *module) {
     this->module = module;
 }
 
@@ -75,13 +130,17 @@ void Task::set_taskdata(TaskData *taskdata) {
 }
 
 std::string Task::get_name() const {
-    return module->name();
+    return name;
 }
 
 TaskData* Task::get_taskdata() const {
     return this->taskdata;
 }
 
+TaskSet::TaskSet(Processor *processor) {
+    this->processor = processor;
+}
+
 void TaskSet::add_task(Task* task) {
     this->tasks.push_back(task);
 }
@@ -1,48 +1,60 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
+#include <string>
 #include <vector>
-#include <systemc.h>
 
 enum SchedulingParameter {
     PARAM_WCET,
     PARAM_START_TIME,
     PARAM_PERIOD,
     PARAM_DEADLINE,
-    PARAM_PRIORITY
+    PARAM_PRIORITY,
+    PARAM_MIGRATING
 };
 
 class sc_schedulable_module;
+class ReleaseQueue;
 
 class TaskData {
 };
 
 class Task {
+    friend class SchedulingKernel;
     friend class sc_scheduler;
-    const sc_schedulable_module *module;
-    sc_event run_event;
+    std::string name;
+    int id;                 // Dense index, assigned by SystemBuilder
+    sc_schedulable_module *module;          // NULL when simulating schedules only
+    int slice;              // Ticks the task may run without a new handshake
     TaskData *taskdata;
 
 public:
     Task();
-    Task(const sc_schedulable_module *module);
+    Task(const std::string &name);
     ~Task();
-    void set_module(const sc_schedulable_module *module);
+    void set_name(const std::string &name);
+    void set_id(int id);
+    int get_id() const;
+    void set_module(sc_schedulable_module *module);
     void set_taskdata(TaskData *taskdata);
     TaskData* get_taskdata() const;
     std::string get_name() const;
 };
 
 class Processor {
-    friend class sc_scheduler;
+    friend class SchedulingKernel;
     std::string name;
+    int id;                 // Dense index, assigned by SystemBuilder
     Task *previous;
     Task *current;
     Task *next;
+    int next_slice;
 public:
-    void set_next(Task *task);
+    void set_next(Task *task, int slice = 1);
     void set_name(const std::string &name);
     std::string get_name() const;
+    void set_id(int id);
+    int get_id() const;
     Task* get_previous() const;
     Task* get_current() const;
     Task* get_next() const;
@@ -64,7 +76,9 @@ protected:
     std::vector<Task*> tasks;
     std::vector<Processor*> processors;
     std::vector<TaskSet*> tasksets;
+    ReleaseQueue *release_queue;
 public:
+    Scheduler();
     void set_name(const std::string &name);
     std::string get_name() const;
     virtual void add_task(Task* task);
@@ -73,6 +87,22 @@ public:
     virtual void set_parameter(Task *task, SchedulingParameter param, const void *value);
     virtual void init();
     virtual void run() = 0;
+
+    // Release events scheduled in the kernel's release queue come back here
+    void set_release_queue(ReleaseQueue *queue);
+    virtual void task_released(int index);
+
+    // Idle fast-forward support: a scheduler is idle if nothing can happen
+    // before the next event in the release queue.
+    virtual bool is_idle() const;
+    virtual void skip_ticks(int ticks);
+
+    // Steady-state detection and checkpoints: appends the scheduler state with
+    // all times relative to the current tick (false if not supported), moves all
+    // absolute times, and restores a saved state after init() at the given tick.
+    virtual bool save_state(std::vector<int> &state) const;
+    virtual void shift_time(int delta);
+    virtual bool restore_state(const std::vector<int> &state, int tick);
 };
 
 #endif // SCHEDULER_H
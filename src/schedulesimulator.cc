@@ -0,0 +1,118 @@
+#include <iostream>
+#include <fstream>
+#include "schedulesimulator.h"
+using namespace std;
+
+// Checkpoint file: header, then the sections as a count followed by that many
+// ints. Everything is stored in native byte order.
+static const unsigned int checkpoint_magic = 0x4b435353;    // "SSCK"
+static const unsigned int checkpoint_version = 1;
+
+struct CheckpointHeader {
+    unsigned int magic;
+    unsigned int version;
+    unsigned long long fingerprint;
+    int tick;
+    unsigned int sections;
+};
+
+ScheduleSimulator::ScheduleSimulator() {
+    started = false;
+}
+
+void ScheduleSimulator::run(int simulation_time) {
+    if (!started) {
+        init();
+        started = true;
+    }
+
+    // Resumed from a checkpoint: continue with the first boundary still ahead
+    if (steady_period > 0 && steady_boundary < tick) {
+        long long periods = (static_cast<long long>(tick) - steady_boundary + steady_period - 1) / steady_period;
+        steady_boundary += periods * steady_period;
+    }
+
+    while (tick < simulation_time) {
+        if (steady_period > 0 && tick == steady_boundary) {
+            check_steady_state(simulation_time);
+            if (tick >= simulation_time) {
+                break;
+            }
+        }
+        step();
+
+        // Jump over ticks in which all processors stay idle
+        int skip = idle_ticks(tick - 1);
+        if (steady_period > 0 && skip > steady_boundary - tick) {
+            skip = steady_boundary - tick;
+        }
+        if (skip > 0) {
+            skip_ticks(skip);
+        }
+    }
+}
+
+bool ScheduleSimulator::write_checkpoint(const char *filename) const {
+    vector<vector<int> > sections;
+    if (!save_checkpoint(sections)) {
+        return false;
+    }
+
+    ofstream stream(filename, ios::binary);
+    if (!stream) {
+        cerr << "Error: cannot write checkpoint '" << filename << "'" << endl;
+        return false;
+    }
+
+    CheckpointHeader header = { checkpoint_magic, checkpoint_version, fingerprint(), tick,
+                                static_cast<unsigned int>(sections.size()) };
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto &section : sections) {
+        unsigned int size = section.size();
+        stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        stream.write(reinterpret_cast<const char*>(section.data()), size * sizeof(int));
+    }
+    return stream.good();
+}
+
+bool ScheduleSimulator::read_checkpoint(const char *filename) {
+    ifstream stream(filename, ios::binary);
+    if (!stream) {
+        cerr << "Error: cannot open checkpoint '" << filename << "'" << endl;
+        return false;
+    }
+
+    CheckpointHeader header;
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != checkpoint_magic
+            || header.version != checkpoint_version) {
+        cerr << "Error: '" << filename << "' is not a checkpoint" << endl;
+        return false;
+    }
+    if (header.fingerprint != fingerprint()) {
+        cerr << "Error: checkpoint '" << filename << "' was written for a different system" << endl;
+        return false;
+    }
+
+    vector<vector<int> > sections(header.sections);
+    for (auto &section : sections) {
+        unsigned int size;
+        if (!stream.read(reinterpret_cast<char*>(&size), sizeof(size)) || size > (1u << 28)) {
+            cerr << "Error: checkpoint '" << filename << "' is truncated" << endl;
+            return false;
+        }
+        section.resize(size);
+        if (!stream.read(reinterpret_cast<char*>(section.data()), size * sizeof(int))) {
+            cerr << "Error: checkpoint '" << filename << "' is truncated" << endl;
+            return false;
+        }
+    }
+
+    if (started) {
+        cerr << "Error: checkpoints can only be read before the simulation starts" << endl;
+        return false;
+    }
+    init();
+    started = true;
+    tick = header.tick;
+    return restore_checkpoint(sections);
+}
@@ -0,0 +1,23 @@
+#ifndef SCHEDULESIMULATOR_H
+#define SCHEDULESIMULATOR_H
+
+#include "schedulingkernel.h"
+
+// Schedule-only simulation: runs the schedulers and monitors in a tight
+// loop, without SystemC processes for the tasks. Every task is assumed to
+// execute for its full wcet whenever it is scheduled.
+class ScheduleSimulator : public SchedulingKernel {
+    bool started;
+public:
+    ScheduleSimulator();
+    void run(int simulation_time);
+
+    // Checkpoints of the whole simulation state at the current tick, so that a
+    // common prefix only has to be simulated once. A checkpoint can be read into
+    // a simulator built from the same system, possibly with other parameters,
+    // and run() then continues from its tick.
+    bool write_checkpoint(const char *filename) const;
+    bool read_checkpoint(const char *filename);
+};
+
+#endif // SCHEDULESIMULATOR_H
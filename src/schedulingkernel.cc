@@ -0,0 +1,375 @@
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include "schedulingkernel.h"
+#include "monitor.h"
+using namespace std;
+
+SchedulingKernel::SchedulingKernel() {
+    tick = 0;
+    fast_forward_end = -1;
+    steady_boundary = 0;
+    steady_period = 0;
+    steady_hash = 0;
+    steady_matches = 0;
+}
+
+SchedulingKernel::~SchedulingKernel() {
+    for (auto t : tasksets) {
+        delete t;
+    }
+}
+
+void SchedulingKernel::init() {
+    if (processors.size() == 0) {
+        cerr << "Error: no processors defined" << endl;
+        exit(1);
+    }
+
+    for (auto s : schedulers) {
+        s->init();
+    }
+}
+
+void SchedulingKernel::step() {
+    releases.expire(tick);
+
+    for (auto s : schedulers) {
+        s->run();
+    }
+
+    // Run the tasks for each processor
+    for (auto p : processors) {
+
+        if (p->current != p->next) {
+            // Task preempted / resumed
+            for (auto m : monitors) {
+                if (p->current) m->task_preempted(p->current, p);
+                if (p->next) m->task_resumed(p->next, p);
+            }
+        }
+
+        p->previous = p->current;
+        p->current = p->next;
+        p->next = NULL;
+        if (p->current) {
+            p->current->slice = p->next_slice;
+            last_processor[p->current->get_id()] = p->id;
+            dispatch(p->current);
+        }
+    }
+
+    for (auto m : monitors) {
+        m->advance_time();
+    }
+    tick++;
+}
+
+int SchedulingKernel::idle_ticks(long long now) const {
+    if (fast_forward_end < 0) {
+        return 0;
+    }
+
+    for (auto p : processors) {
+        if (p->current) {
+            return 0;
+        }
+    }
+
+    for (auto s : schedulers) {
+        if (!s->is_idle()) {
+            return 0;
+        }
+    }
+    int next_release = releases.next_time();
+
+    // Never skip ticks that would not have been simulated anymore, otherwise the
+    // monitors would end up with a different notion of time than per-tick stepping.
+    long long skip = static_cast<long long>(next_release) - tick;
+    if (skip > fast_forward_end - 1 - now) {
+        skip = fast_forward_end - 1 - now;
+    }
+
+    return skip > 0 ? static_cast<int>(skip) : 0;
+}
+
+void SchedulingKernel::skip_ticks(int ticks) {
+    for (auto s : schedulers) {
+        s->skip_ticks(ticks);
+    }
+    for (auto m : monitors) {
+        m->advance_time(ticks);
+    }
+    tick += ticks;
+}
+
+// Collects everything that decides how the simulation continues from the
+// current tick on, with all times relative to it
+bool SchedulingKernel::save_state(vector<int> &state) const {
+    for (auto s : schedulers) {
+        if (!s->save_state(state)) {
+            return false;
+        }
+    }
+    for (auto p : processors) {
+        state.push_back(p->current ? p->current->get_id() : -1);
+    }
+    state.insert(state.end(), last_processor.begin(), last_processor.end());
+
+    vector<ReleaseQueue::Pending> pending;
+    releases.pending(pending);
+    vector<int> events;
+    for (const auto &e : pending) {
+        int sched = find(schedulers.begin(), schedulers.end(), e.sched) - schedulers.begin();
+        events.push_back(e.time - tick);
+        events.push_back(sched);
+        events.push_back(e.index);
+    }
+    // The wheel does not keep events of the same time in a defined order
+    vector<int> order(pending.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&events](int a, int b) {
+        return lexicographical_compare(events.begin() + 3 * a, events.begin() + 3 * a + 3,
+                                       events.begin() + 3 * b, events.begin() + 3 * b + 3);
+    });
+    state.push_back(pending.size());
+    for (int i : order) {
+        state.insert(state.end(), events.begin() + 3 * i, events.begin() + 3 * i + 3);
+    }
+    return true;
+}
+
+// Called at the start of the tick steady_boundary. Once the state equals the
+// one a period ago, the schedule repeats from there on. The monitors still
+// see one more period, so that every run they account for started inside
+// the repeating part; the remaining whole periods up to end are then not
+// simulated but extrapolated.
+void SchedulingKernel::check_steady_state(int end) {
+    vector<int> state;
+    bool supported = save_state(state);
+    for (auto m : monitors) {
+        supported = supported && m->can_extrapolate();
+    }
+    if (!supported) {
+        cerr << "Warning: steady-state detection is not supported by this configuration" << endl;
+        steady_period = 0;
+        return;
+    }
+
+    // FNV-1a, so that differing states rarely need a full comparison
+    unsigned long long hash = 14695981039346656037ULL;
+    for (int v : state) {
+        hash = (hash ^ static_cast<unsigned int>(v)) * 1099511628211ULL;
+    }
+
+    if (!steady_state.empty() && hash == steady_hash && state == steady_state) {
+        steady_matches++;
+    } else {
+        steady_matches = 0;
+    }
+
+    if (steady_matches == 2) {
+        int periods = (end - tick) / steady_period;
+        if (periods > 0) {
+            int delta = periods * steady_period;
+            cout << "Steady state reached at tick " << tick - steady_period << ", skipping " << periods
+                 << " periods of " << steady_period << " ticks" << endl;
+            for (auto s : schedulers) {
+                s->shift_time(delta);
+            }
+            releases.shift(delta);
+            for (auto m : monitors) {
+                m->extrapolate(periods, steady_period);
+                m->advance_time(delta);
+            }
+            tick += delta;
+        }
+        steady_period = 0;
+        return;
+    }
+
+    for (auto m : monitors) {
+        m->mark_period();
+    }
+    steady_state.swap(state);
+    steady_hash = hash;
+    if (steady_boundary > end - steady_period) {
+        // No complete period is left to skip
+        steady_period = 0;
+    } else {
+        steady_boundary += steady_period;
+    }
+}
+
+// Identifies the structure of the system, a checkpoint can be restored into
+// a system with different task parameters but not with different tasks
+unsigned long long SchedulingKernel::fingerprint() const {
+    unsigned long long hash = 14695981039346656037ULL;
+    auto add = [&hash](const string &s) {
+        for (unsigned char c : s) {
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+        hash = (hash ^ 0xff) * 1099511628211ULL;
+    };
+    for (auto t : tasks) {
+        add(to_string(t->get_id()) + ":" + t->get_name());
+    }
+    for (auto p : processors) {
+        add(to_string(p->id) + ":" + p->name);
+    }
+    for (auto s : schedulers) {
+        add(s->get_name());
+    }
+    return hash;
+}
+
+bool SchedulingKernel::save_checkpoint(vector<vector<int> > &sections) const {
+    sections.clear();
+    for (auto s : schedulers) {
+        sections.push_back(vector<int>());
+        if (!s->save_state(sections.back())) {
+            cerr << "Error: scheduler '" << s->get_name() << "' does not support checkpoints" << endl;
+            return false;
+        }
+    }
+
+    vector<int> running;
+    for (auto p : processors) {
+        running.push_back(p->current ? p->current->get_id() : -1);
+        running.push_back(p->previous ? p->previous->get_id() : -1);
+    }
+    sections.push_back(running);
+    sections.push_back(last_processor);
+
+    vector<ReleaseQueue::Pending> pending;
+    releases.pending(pending);
+    vector<int> events;
+    for (const auto &e : pending) {
+        events.push_back(e.time - tick);
+        events.push_back(find(schedulers.begin(), schedulers.end(), e.sched) - schedulers.begin());
+        events.push_back(e.index);
+    }
+    sections.push_back(events);
+
+    for (auto m : monitors) {
+        if (!m->save_sections(sections)) {
+            cerr << "Error: monitor does not support checkpoints" << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Must be called after init(), with tick already set to the checkpoint's tick
+bool SchedulingKernel::restore_checkpoint(const vector<vector<int> > &sections) {
+    size_t section = 0;
+    size_t monitor_sections = 0;
+    for (auto m : monitors) {
+        monitor_sections += m->get_num_sections();
+    }
+    if (sections.size() != schedulers.size() + 3 + monitor_sections) {
+        cerr << "Error: checkpoint does not match the system" << endl;
+        return false;
+    }
+
+    for (auto s : schedulers) {
+        if (!s->restore_state(sections[section++], tick)) {
+            cerr << "Error: invalid checkpoint state for scheduler '" << s->get_name() << "'" << endl;
+            return false;
+        }
+    }
+
+    vector<Task*> by_id(last_processor.size(), NULL);
+    for (auto t : tasks) {
+        by_id[t->get_id()] = t;
+    }
+    auto task = [&by_id](int id) -> Task* {
+        return id >= 0 && id < static_cast<int>(by_id.size()) ? by_id[id] : NULL;
+    };
+    const vector<int> &running = sections[section++];
+    if (running.size() != 2 * processors.size()) {
+        cerr << "Error: checkpoint does not match the processors" << endl;
+        return false;
+    }
+    for (size_t i = 0; i < processors.size(); i++) {
+        processors[i]->current = task(running[2 * i]);
+        processors[i]->previous = task(running[2 * i + 1]);
+        processors[i]->next = NULL;
+    }
+
+    if (sections[section].size() != last_processor.size()) {
+        cerr << "Error: checkpoint does not match the tasks" << endl;
+        return false;
+    }
+    last_processor = sections[section++];
+
+    // Replace the initial releases queued by init()
+    const vector<int> &events = sections[section++];
+    releases.clear();
+    for (size_t i = 0; i + 2 < events.size(); i += 3) {
+        if (events[i + 1] < 0 || events[i + 1] >= static_cast<int>(schedulers.size())) {
+            cerr << "Error: invalid release in checkpoint" << endl;
+            return false;
+        }
+        releases.schedule(events[i] + tick, schedulers[events[i + 1]], events[i + 2]);
+    }
+
+    for (auto m : monitors) {
+        if (!m->restore_sections(&sections[section], tick)) {
+            cerr << "Error: invalid checkpoint state for monitor" << endl;
+            return false;
+        }
+        section += m->get_num_sections();
+    }
+    return true;
+}
+
+void SchedulingKernel::dispatch(Task *task) {
+}
+
+void SchedulingKernel::add_scheduler(Scheduler *sched) {
+    this->schedulers.push_back(sched);
+    sched->set_release_queue(&releases);
+}
+
+void SchedulingKernel::add_task(Task *task) {
+    tasks.push_back(task);
+    if (task->get_id() >= static_cast<int>(last_processor.size())) {
+        last_processor.resize(task->get_id() + 1, -1);
+    }
+    for (auto m : monitors) {
+        m->add_task(task);
+    }
+}
+
+void SchedulingKernel::add_processor(Processor *processor) {
+    processors.push_back(processor);
+    for (auto m : monitors) {
+        m->add_processor(processor);
+    }
+}
+
+void SchedulingKernel::add_taskset(TaskSet *taskset) {
+    tasksets.push_back(taskset);
+}
+
+void SchedulingKernel::add_monitor(Monitor *monitor) {
+    this->monitors.push_back(monitor);
+}
+
+int SchedulingKernel::get_tick() const {
+    return tick;
+}
+
+void SchedulingKernel::enable_fast_forward(int simulation_time) {
+    fast_forward_end = simulation_time;
+}
+
+void SchedulingKernel::enable_steady_state_detection(int start, int period) {
+    steady_boundary = start;
+    steady_period = period;
+    steady_state.clear();
+    steady_matches = 0;
+}
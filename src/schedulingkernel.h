@@ -0,0 +1,64 @@
+#ifndef SCHEDULINGKERNEL_H
+#define SCHEDULINGKERNEL_H
+
+#include <vector>
+#include "scheduler.h"
+#include "releasequeue.h"
+
+class Monitor;
+
+// Drives the schedulers tick by tick and reports task switches to the
+// monitors. It does not depend on SystemC: sc_scheduler runs it from a
+// SystemC thread, ScheduleSimulator runs it in a plain loop.
+class SchedulingKernel {
+protected:
+    std::vector<Task*> tasks;
+    std::vector<TaskSet*> tasksets;
+    std::vector<Processor*> processors;
+    std::vector<Monitor*> monitors;
+    std::vector<Scheduler*> schedulers;
+    ReleaseQueue releases;
+
+    int tick;
+    int fast_forward_end;
+
+    // Steady-state detection: the state is compared every steady_period ticks
+    // from steady_boundary on, detection is off while steady_period is 0
+    int steady_boundary;
+    int steady_period;
+    std::vector<int> steady_state;
+    unsigned long long steady_hash;
+    int steady_matches;
+    std::vector<int> last_processor;    // Indexed by task id
+
+    void init();
+    void step();
+    int idle_ticks(long long now) const;
+    void skip_ticks(int ticks);
+    bool save_state(std::vector<int> &state) const;
+    void check_steady_state(int end);
+
+    // Checkpoints: one section per scheduler, then the processors, the last
+    // processor of each task, the pending releases and the sections of the monitors
+    unsigned long long fingerprint() const;
+    bool save_checkpoint(std::vector<std::vector<int> > &sections) const;
+    bool restore_checkpoint(const std::vector<std::vector<int> > &sections);
+
+    // Called for every task that runs in the current tick
+    virtual void dispatch(Task *task);
+
+public:
+    SchedulingKernel();
+    virtual ~SchedulingKernel();
+
+    void add_scheduler(Scheduler *sched);
+    virtual void add_task(Task *task);
+    void add_processor(Processor *processor);
+    void add_taskset(TaskSet *taskset);
+    void add_monitor(Monitor *monitor);
+    void enable_fast_forward(int simulation_time);
+    int get_tick() const;
+    void enable_steady_state_detection(int start, int period);
+};
+
+#endif // SCHEDULINGKERNEL_H
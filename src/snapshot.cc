@@ -0,0 +1,36 @@
+#include <iostream>
+#include "system/streamingsystemloader.h"
+#include "system/systemvalidator.h"
+#include "system/systemsnapshot.h"
+using namespace std;
+
+// Writes the snapshot of a system file ahead of time, for runs with schedsim -c
+int main(int argc, char *argv[]) {
+    StreamingSystemLoader sl;
+
+    if (argc != 3) {
+        cerr << "Usage: " << argv[0] << " <xml-file> <snapshot-file>" << endl;
+        return -1;
+    }
+
+    unsigned long long hash;
+    if (!SystemSnapshot::hash_file(argv[1], hash)) {
+        return -3;
+    }
+
+    systemdata::System* system = sl.load(argv[1]);
+    if (!system) {
+        cerr << sl.get_errors();
+        return -3;
+    }
+
+    SystemValidator sv(system);
+    if (!sv.validate()) {
+        delete system;
+        return -2;
+    }
+
+    int ret = SystemSnapshot::write(system, hash, argv[2]) ? 0 : 1;
+    delete system;
+    return ret;
+}
@@ -0,0 +1,342 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <unordered_map>
+#include "staticscheduler.h"
+#include "edfqueue.h"
+#include "releasequeue.h"
+using namespace std;
+
+static long long gcd(long long a, long long b) {
+    while (b != 0) {
+        long long t = b;
+        b = a % b;
+        a = t;
+    }
+    return a;
+}
+
+StaticScheduler::StaticScheduler() {
+    tick = 0;
+}
+
+long long StaticScheduler::hyperperiod(const vector<int> &task_indices) const {
+    long long h = 1;
+    for (auto t : task_indices) {
+        h = h / gcd(h, data[t]->period) * data[t]->period;
+        if (h > numeric_limits<int>::max()) {
+            break;
+        }
+    }
+    return h;
+}
+
+void StaticScheduler::append_slot(Table &table, int task, int start, int end) {
+    // Extend the previous slot if it runs the same task, but never across the start of the cycle
+    if (!table.slots.empty() && static_cast<int>(table.slots.size()) != table.cycle_index &&
+        table.slots.back().task == task && table.slots.back().end == start) {
+        table.slots.back().end = end;
+        return;
+    }
+
+    Slot slot = { start, end, task };
+    table.slots.push_back(slot);
+}
+
+void StaticScheduler::generate_table(Table &table, const vector<int> &task_indices) {
+    int n = task_indices.size();
+    long long h = hyperperiod(task_indices);
+    long long s = 0;
+    for (auto t : task_indices) {
+        if (data[t]->start_time > s) {
+            s = data[t]->start_time;
+        }
+    }
+
+    if (s + 2 * h > numeric_limits<int>::max()) {
+        cerr << "Fatal error: hyperperiod of scheduler '" << get_name() << "' is too large for a static table" << endl;
+        exit(1);
+    }
+
+    int cycle_start = s + h;
+    int end = s + 2 * h;
+    table.cycle = h;
+    table.cycle_index = -1;
+
+    // Offline EDF run, with the same tie-breaking as EDFScheduler
+    EDFQueue ready, waiting;
+    vector<int> release(n), abs_deadline(n), remaining(n, 0);
+    for (int k = 0; k < n; k++) {
+        release[k] = data[task_indices[k]]->start_time;
+        waiting.push(k, release[k]);
+    }
+
+    bool missed = false;
+    int t = 0;
+    while (t < end) {
+        while (!waiting.empty() && waiting.top_key() <= t) {
+            int k = waiting.top();
+            waiting.pop();
+            remaining[k] = data[task_indices[k]]->wcet;
+            abs_deadline[k] = release[k] + data[task_indices[k]]->deadline;
+            ready.push(k, abs_deadline[k]);
+        }
+
+        int until = end;
+        if (!waiting.empty() && waiting.top_key() < until) {
+            until = waiting.top_key();
+        }
+
+        int task = -1;
+        int k = -1;
+        if (!ready.empty()) {
+            k = ready.top();
+            task = task_indices[k];
+            if (t + remaining[k] < until) {
+                until = t + remaining[k];
+            }
+        }
+
+        // Split at the start of the cycle, so the repeating part starts with its own slot
+        if (t < cycle_start && until > cycle_start) {
+            append_slot(table, task, t, cycle_start);
+            if (k >= 0) {
+                remaining[k] -= cycle_start - t;
+            }
+            t = cycle_start;
+        }
+        if (t == cycle_start) {
+            table.cycle_index = table.slots.size();
+        }
+        append_slot(table, task, t, until);
+
+        if (k >= 0) {
+            remaining[k] -= until - t;
+            if (remaining[k] == 0) {
+                ready.pop();
+                if (until > abs_deadline[k]) {
+                    missed = true;
+                }
+                release[k] += data[task]->period;
+                waiting.push(k, release[k]);
+            }
+        }
+        t = until;
+    }
+
+    if (missed) {
+        cerr << "Warning: static table of scheduler '" << get_name() << "' misses deadlines" << endl;
+    }
+}
+
+void StaticScheduler::explicit_table(Table &table, Processor *processor, int cycle, const unordered_map<const Task*, int> &index) {
+    vector<ExplicitSlot> slots;
+    for (auto &slot : explicit_slots) {
+        if (slot.processor == processor) {
+            slots.push_back(slot);
+        }
+    }
+    sort(slots.begin(), slots.end(), [](const ExplicitSlot &x, const ExplicitSlot &y) { return x.start < y.start; });
+
+    table.cycle = cycle;
+    table.cycle_index = 0;
+    int t = 0;
+    for (auto &slot : slots) {
+        if (slot.start < t) {
+            cerr << "Fatal error: overlapping slots for processor '" << processor->get_name() << "' at " << slot.start << endl;
+            exit(1);
+        }
+        if (static_cast<long long>(slot.start) + slot.length > cycle) {
+            cerr << "Fatal error: slot at " << slot.start << " for processor '" << processor->get_name() << "' exceeds the hyperperiod (" << cycle << ")" << endl;
+            exit(1);
+        }
+
+        // Tasks without a process in this simulation leave their slots idle
+        auto i = index.find(slot.task);
+        int task = i == index.end() ? -1 : i->second;
+
+        if (slot.start > t) {
+            append_slot(table, -1, t, slot.start);
+        }
+        append_slot(table, task, slot.start, slot.start + slot.length);
+        t = slot.start + slot.length;
+    }
+    if (t < cycle) {
+        append_slot(table, -1, t, cycle);
+    }
+}
+
+void StaticScheduler::init() {
+    tables.resize(processors.size());
+
+    unordered_map<const Task*, int> index;
+    vector<int> all_tasks;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        index[tasks[i]] = i;
+        all_tasks.push_back(i);
+    }
+
+    // Explicit tables repeat every hyperperiod of all tasks of the scheduler
+    long long cycle = hyperperiod(all_tasks);
+    if (!explicit_slots.empty() && cycle > numeric_limits<int>::max()) {
+        cerr << "Fatal error: hyperperiod of scheduler '" << get_name() << "' is too large for a static table" << endl;
+        exit(1);
+    }
+
+    for (size_t p = 0; p < processors.size(); p++) {
+        Table &table = tables[p];
+
+        if (!explicit_slots.empty()) {
+            explicit_table(table, processors[p], cycle, index);
+        } else {
+            // Generate the table from the tasks mapped onto this processor
+            vector<int> task_indices;
+            for (auto ts : tasksets) {
+                if (ts->get_processor() != processors[p]) continue;
+                for (auto task : ts->get_tasks()) {
+                    auto i = index.find(task);
+                    if (i != index.end()) {
+                        task_indices.push_back(i->second);
+                    }
+                }
+            }
+            sort(task_indices.begin(), task_indices.end());
+            generate_table(table, task_indices);
+        }
+
+        // A processor that never runs anything does not need to be woken up
+        bool used = false;
+        for (auto &slot : table.slots) {
+            if (slot.task >= 0) {
+                used = true;
+            }
+        }
+        if (!used) {
+            Slot idle = { 0, numeric_limits<int>::max(), -1 };
+            table.slots.assign(1, idle);
+            table.cycle_index = 0;
+            table.cycle = numeric_limits<int>::max();
+        }
+
+        table.base = 0;
+        table.cursor = 0;
+        table.wakeup = -1;
+    }
+}
+
+void StaticScheduler::run() {
+    for (size_t p = 0; p < processors.size(); p++) {
+        Table &table = tables[p];
+
+        // Move to the slot containing the current tick, wrapping into the repeating part
+        while (tick >= table.base + table.slots[table.cursor].end) {
+            table.cursor++;
+            if (table.cursor == static_cast<int>(table.slots.size())) {
+                table.cursor = table.cycle_index;
+                table.base += table.cycle;
+            }
+        }
+
+        const Slot &slot = table.slots[table.cursor];
+        if (slot.task >= 0) {
+            processors[p]->set_next(tasks[slot.task], table.base + slot.end - tick);
+        } else {
+            processors[p]->set_next(NULL);
+
+            // Make sure fast-forwarding stops at the end of the idle slot
+            int end = table.base + slot.end;
+            if (slot.end != numeric_limits<int>::max() && table.wakeup != end) {
+                release_queue->schedule(end, this, -1);
+                table.wakeup = end;
+            }
+        }
+    }
+    tick++;
+}
+
+void StaticScheduler::add_task(Task *task) {
+    Scheduler::add_task(task);
+    StaticSchedulerData *data = new StaticSchedulerData();
+    data->index = this->data.size();
+    task->set_taskdata(data);
+    this->data.push_back(data);
+}
+
+void StaticScheduler::add_slot(Processor *processor, Task *task, int start, int length) {
+    ExplicitSlot slot = { processor, task, start, length };
+    explicit_slots.push_back(slot);
+}
+
+void StaticScheduler::set_parameter(Task *task, SchedulingParameter param, const void *value) {
+    StaticSchedulerData *data = static_cast<StaticSchedulerData*>(task->get_taskdata());
+    switch (param) {
+        case PARAM_WCET:
+            data->wcet = *static_cast<const int*>(value);
+            break;
+        case PARAM_START_TIME:
+            data->start_time = *static_cast<const int*>(value);
+            break;
+        case PARAM_PERIOD:
+            data->period = *static_cast<const int*>(value);
+            break;
+        case PARAM_DEADLINE:
+            data->deadline = *static_cast<const int*>(value);
+            break;
+        default:
+            break;
+    }
+}
+
+bool StaticScheduler::is_idle() const {
+    for (auto processor : processors) {
+        if (processor->get_current()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void StaticScheduler::skip_ticks(int ticks) {
+    tick += ticks;
+}
+
+bool StaticScheduler::save_state(std::vector<int> &state) const {
+    for (auto &table : tables) {
+        state.push_back(table.cursor);
+        state.push_back(table.base - tick);
+        // A wake-up that already passed can never match a later idle slot
+        state.push_back(table.wakeup <= tick ? -1 : table.wakeup - tick);
+    }
+    return true;
+}
+
+bool StaticScheduler::restore_state(const std::vector<int> &state, int tick) {
+    if (state.size() != 3 * tables.size()) {
+        return false;
+    }
+
+    this->tick = tick;
+    for (size_t p = 0; p < tables.size(); p++) {
+        Table &table = tables[p];
+        const int *s = &state[3 * p];
+        if (s[0] < 0 || s[0] >= static_cast<int>(table.slots.size())) {
+            return false;
+        }
+        table.cursor = s[0];
+        table.base = s[1] + tick;
+        table.wakeup = s[2] < 0 ? -1 : s[2] + tick;
+    }
+    return true;
+}
+
+void StaticScheduler::shift_time(int delta) {
+    tick += delta;
+    for (auto &table : tables) {
+        table.base += delta;
+        if (table.wakeup >= 0) {
+            table.wakeup += delta;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef STATICSCHEDULER_H
+#define STATICSCHEDULER_H
+
+#include <vector>
+#include <unordered_map>
+#include "scheduler.h"
+
+class StaticSchedulerData : public TaskData {
+    friend class StaticScheduler;
+    int index;              // Position in the scheduler's task list
+    int start_time;
+    int wcet;
+    int period;
+    int deadline;
+};
+
+// Time-triggered scheduler that dispatches from a precomputed table per
+// processor. The table is either given explicitly (slots in the system file,
+// repeating every hyperperiod) or generated at init by an offline EDF run over
+// [0, S + 2H), after which [S + H, S + 2H) repeats. Slots are run-length
+// encoded, so every tick costs one comparison against the current slot.
+class StaticScheduler : public Scheduler {
+    struct Slot {
+        int start;
+        int end;            // Exclusive
+        int task;           // Index of the task, -1 if idle
+    };
+
+    struct Table {
+        std::vector<Slot> slots;
+        int cycle_index;    // First slot of the repeating part
+        int cycle;          // Length of the repeating part
+        int base;           // Offset of the current repetition
+        int cursor;         // Current slot
+        int wakeup;         // End of the idle slot we asked to be woken up for
+    };
+
+    struct ExplicitSlot {
+        Processor *processor;
+        Task *task;
+        int start;
+        int length;
+    };
+
+    std::vector<StaticSchedulerData*> data;     // Indexed like tasks
+    std::vector<Table> tables;                  // Indexed like processors
+    std::vector<ExplicitSlot> explicit_slots;
+    int tick;
+
+    void generate_table(Table &table, const std::vector<int> &task_indices);
+    void explicit_table(Table &table, Processor *processor, int cycle, const std::unordered_map<const Task*, int> &index);
+    static void append_slot(Table &table, int task, int start, int end);
+    long long hyperperiod(const std::vector<int> &task_indices) const;
+
+public:
+    StaticScheduler();
+    void init();
+    void run();
+    void add_task(Task *task);
+    void add_slot(Processor *processor, Task *task, int start, int length);
+    void set_parameter(Task *task, SchedulingParameter param, const void *value);
+    bool is_idle() const;
+    void skip_ticks(int ticks);
+    bool save_state(std::vector<int> &state) const;
+    void shift_time(int delta);
+    bool restore_state(const std::vector<int> &state, int tick);
+};
+
+#endif // STATICSCHEDULER_H
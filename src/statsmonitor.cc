@@ -1,6 +1,7 @@
 #include <iostream>
 #include "statsmonitor.h"
 #include "scheduler.h"
+#include "csv.h"
 using namespace std;
 
 // Helper function to write table rows to the output stream and take care of the spacing.
@@ -15,32 +16,62 @@ static void write_table_row(ostream &stream, const string &s1, const string &s2,
     stream << "|" << endl;
 }
 
+ProcStats& StatsMonitor::stats(const Processor *p) {
+    unsigned int id = p->get_id();
+    if (id >= proc_stats.size()) {
+        proc_stats.resize(id + 1);
+    }
+    proc_stats[id].proc = p;
+    return proc_stats[id];
+}
+
+TaskStats& StatsMonitor::stats(const Task *t) {
+    unsigned int id = t->get_id();
+    if (id >= task_stats.size()) {
+        task_stats.resize(id + 1);
+    }
+    task_stats[id].task = t;
+    return task_stats[id];
+}
+
+StatsMonitor::StatsMonitor() {
+    mark_time = 0;
+}
+
 void StatsMonitor::add_processor(const Processor *p) {
+    stats(p);
 }
 
 void StatsMonitor::add_task(const Task *t) {
+    stats(t);
 }
 
 void StatsMonitor::task_preempted(const Task *t, const Processor *p) {
-    task_stats[t].et += get_time() - task_stats[t].last_resume;
-    proc_stats[task_stats[t].proc].util += get_time() - task_stats[t].last_resume;
-    task_stats[t].last_preempt = get_time();
+    TaskStats &ts = stats(t);
+    ProcStats &ps = stats(ts.proc);
+    ts.et += get_time() - ts.last_resume;
+    ps.util += get_time() - ts.last_resume;
+    ps.used = true;
+    ts.last_preempt = get_time();
 }
 
 void StatsMonitor::task_resumed(const Task *t, const Processor *p) {
-    task_stats[t].last_resume = get_time();
-    if (task_stats[t].proc != p) {
-        task_stats[t].proc = p;
-        task_stats[t].migrations++;
+    TaskStats &ts = stats(t);
+    ts.last_resume = get_time();
+    if (ts.proc != p) {
+        ts.proc = p;
+        ts.migrations++;
     }
 }
 
 void StatsMonitor::simulation_finished() {
     // Update execution time for tasks that were running at the end of the simulation
     for (auto &ts : task_stats) {
-        if (ts.second.last_resume >= ts.second.last_preempt) {      // we need to check >=, because a task might be preempted and resumed in the same cycle (migration)
-            ts.second.et += get_time() - ts.second.last_resume;
-            proc_stats[ts.second.proc].util += get_time() - ts.second.last_resume;
+        if (ts.proc && ts.last_resume >= ts.last_preempt) {      // we need to check >=, because a task might be preempted and resumed in the same cycle (migration)
+            ProcStats &ps = stats(ts.proc);
+            ts.et += get_time() - ts.last_resume;
+            ps.util += get_time() - ts.last_resume;
+            ps.used = true;
         }
     }
 }
@@ -54,10 +85,11 @@ void StatsMonitor::write_stats(ostream &stream) {
     int total_et = 0;
     int total_migrations = 0;
     for (const auto &t : task_stats) {
-        write_table_row(stream, t.first->get_name(), "Execution time", to_string(t.second.et));
-        write_table_row(stream, "", "Migrations", to_string(t.second.migrations));
-        total_et += t.second.et;
-        total_migrations += t.second.migrations;
+        if (!t.proc) continue;      // never ran
+        write_table_row(stream, t.task->get_name(), "Execution time", to_string(t.et));
+        write_table_row(stream, "", "Migrations", to_string(t.migrations));
+        total_et += t.et;
+        total_migrations += t.migrations;
     }
     stream << "+--------------------+--------------------+--------------------+" << endl;
     write_table_row(stream, "Total", "Execution time", to_string(total_et));
@@ -72,13 +104,101 @@ void StatsMonitor::write_stats(ostream &stream) {
            << "+--------------------+--------------------+--------------------+" << endl;
     int total_util = 0;
     for (const auto &p : proc_stats) {
-        write_table_row(stream, p.first->get_name(), "Utilization", to_string(p.second.util / static_cast<double>(get_time())));
-        total_util += p.second.util;
+        if (!p.used) continue;
+        write_table_row(stream, p.proc->get_name(), "Utilization", to_string(p.util / static_cast<double>(get_time())));
+        total_util += p.util;
     }
     stream << "+--------------------+--------------------+--------------------+" << endl;
     write_table_row(stream, "Total", "Utilization", to_string(total_util / static_cast<double>(get_time())));
     stream << "+--------------------+--------------------+--------------------+" << endl;
 }
 
+// Machine-readable variant of write_stats(): one "kind,name,metric,value" line per figure
+void StatsMonitor::write_stats_csv(ostream &stream) {
+    for (const auto &t : task_stats) {
+        if (!t.proc) continue;
+        stream << "task," << csv_field(t.task->get_name()) << ",execution_time," << t.et << endl;
+        stream << "task," << csv_field(t.task->get_name()) << ",migrations," << t.migrations << endl;
+    }
+    for (const auto &p : proc_stats) {
+        if (!p.used) continue;
+        stream << "processor," << csv_field(p.proc->get_name()) << ",utilization," << p.util / static_cast<double>(get_time()) << endl;
+    }
+}
+
+bool StatsMonitor::can_extrapolate() const {
+    return true;
+}
+
+void StatsMonitor::mark_period() {
+    for (auto &ts : task_stats) {
+        ts.mark_et = ts.et;
+        ts.mark_migrations = ts.migrations;
+    }
+    for (auto &ps : proc_stats) {
+        ps.mark_util = ps.util;
+    }
+    mark_time = get_time();
+}
+
+void StatsMonitor::extrapolate(int periods, int length) {
+    for (auto &ts : task_stats) {
+        ts.et += (ts.et - ts.mark_et) * periods;
+        ts.migrations += (ts.migrations - ts.mark_migrations) * periods;
+
+        // Runs that started before the last mark simply continue, later ones
+        // are repeated with the skipped periods
+        if (ts.last_preempt >= mark_time) ts.last_preempt += periods * length;
+        if (ts.last_resume >= mark_time) ts.last_resume += periods * length;
+    }
+    for (auto &ps : proc_stats) {
+        ps.util += (ps.util - ps.mark_util) * periods;
+    }
+}
+
+bool StatsMonitor::save_state(vector<int> &state) const {
+    state.push_back(get_time());
+    state.push_back(proc_stats.size());
+    state.push_back(task_stats.size());
+    for (const auto &ps : proc_stats) {
+        state.push_back(ps.util);
+        state.push_back(ps.used);
+    }
+    for (const auto &ts : task_stats) {
+        state.push_back(ts.proc ? ts.proc->get_id() : -1);
+        state.push_back(ts.et);
+        state.push_back(ts.last_preempt);
+        state.push_back(ts.last_resume);
+        state.push_back(ts.migrations);
+    }
+    return true;
+}
+
+bool StatsMonitor::restore_state(const vector<int> &state) {
+    if (state.size() < 3 || state[1] != static_cast<int>(proc_stats.size()) || state[2] != static_cast<int>(task_stats.size())
+            || state.size() != 3 + 2 * proc_stats.size() + 5 * task_stats.size()) {
+        return false;
+    }
+
+    set_time(state[0]);
+    size_t pos = 3;
+    for (auto &ps : proc_stats) {
+        ps.util = state[pos++];
+        ps.used = state[pos++];
+    }
+    for (auto &ts : task_stats) {
+        int proc = state[pos++];
+        if (proc < -1 || proc >= static_cast<int>(proc_stats.size())) {
+            return false;
+        }
+        ts.proc = proc >= 0 ? proc_stats[proc].proc : NULL;
+        ts.et = state[pos++];
+        ts.last_preempt = state[pos++];
+        ts.last_resume = state[pos++];
+        ts.migrations = state[pos++];
+    }
+    return true;
+}
+
 StatsMonitor::~StatsMonitor() {
 }
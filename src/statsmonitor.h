@@ -2,35 +2,52 @@
 #define STATSMONITOR_H
 
 #include <iostream>
-#include <map>
+#include <vector>
 #include "monitor.h"
 
 struct ProcStats {
+    const Processor *proc;
     int util;
-    ProcStats() : util(0) {}
+    bool used;
+    int mark_util;
+    ProcStats() : proc(0), util(0), used(false), mark_util(0) {}
 };
 
 struct TaskStats {
+    const Task *task;
     const Processor *proc;
     int et;
     int last_preempt;
     int last_resume;
     int migrations;
+    int mark_et;
+    int mark_migrations;
 
-    TaskStats() : proc(0), et(0), last_preempt(0), last_resume(0), 
-                  migrations(-1) {}
+    TaskStats() : task(0), proc(0), et(0), last_preempt(0), last_resume(0), 
+                  migrations(-1), mark_et(0), mark_migrations(-1) {}
 };
 
 class StatsMonitor : public Monitor {
-    std::map<const Processor*, ProcStats> proc_stats;
-    std::map<const Task*, TaskStats> task_stats;
+    std::vector<ProcStats> proc_stats;      // Indexed by processor id
+    std::vector<TaskStats> task_stats;      // Indexed by task id
+    int mark_time;
+
+    ProcStats& stats(const Processor *p);
+    TaskStats& stats(const Task *t);
 public:
+    StatsMonitor();
     void add_processor(const Processor *p);
     void add_task(const Task *t);
     void task_preempted(const Task *t, const Processor *p);
     void task_resumed(const Task *t, const Processor *p);
     void simulation_finished();
     void write_stats(std::ostream &stream);
+    void write_stats_csv(std::ostream &stream);
+    bool can_extrapolate() const;
+    void mark_period();
+    void extrapolate(int periods, int length);
+    bool save_state(std::vector<int> &state) const;
+    bool restore_state(const std::vector<int> &state);
     ~StatsMonitor();
 };
 
@@ -0,0 +1,390 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unistd.h>
+#include "system/systemloader.h"
+#include "system/systemvalidator.h"
+using namespace std;
+
+// Generates a C++ translation unit for one system file: all parameters become
+// constexpr tables and every actor a sc_static_csdf_actor instantiated for its
+// rate table, so the simulator for a frequently used system does not have to
+// parse or interpret the system file.
+
+static const int default_fifo_size = 16;       // As used by test.cc
+
+static string quote(const string &s) {
+    string ret = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') ret += '\\';
+        ret += c;
+    }
+    return ret + "\"";
+}
+
+static const char *algorithm_name(systemdata::Algorithm algorithm) {
+    switch (algorithm) {
+        case systemdata::SCHED_NULL: return "systemdata::SCHED_NULL";
+        case systemdata::SCHED_STATIC: return "systemdata::SCHED_STATIC";
+        case systemdata::SCHED_EDF: return "systemdata::SCHED_EDF";
+        case systemdata::SCHED_FP: return "systemdata::SCHED_FP";
+    }
+    return "";
+}
+
+static const char *type_name(systemdata::SchedulerType type) {
+    switch (type) {
+        case systemdata::SCHEDTYPE_GLOBAL: return "systemdata::SCHEDTYPE_GLOBAL";
+        case systemdata::SCHEDTYPE_PARTITIONED: return "systemdata::SCHEDTYPE_PARTITIONED";
+        case systemdata::SCHEDTYPE_HYBRID: return "systemdata::SCHEDTYPE_HYBRID";
+    }
+    return "";
+}
+
+// Emits "constexpr type name[] = {rows};" and its size; an array needs at
+// least one element, so an empty table gets a zero row
+static void emit_table(ostream &out, const char *type, const char *name, const vector<string> &rows, const char *zero_row) {
+    out << "constexpr " << type << " " << name << "[] = {" << endl;
+    for (auto &row : rows) {
+        out << "    " << row << "," << endl;
+    }
+    if (rows.empty()) {
+        out << "    " << zero_row << endl;
+    }
+    out << "};" << endl;
+    out << "constexpr int num_" << name << " = " << rows.size() << ";" << endl << endl;
+}
+
+static void emit_rate_table(ostream &out, const char *name, const vector<const systemdata::Actor::Port*> &ports, int phases) {
+    out << "    static constexpr int " << name << "[" << (ports.empty() ? 1 : ports.size()) << "][" << phases << "] = {";
+    if (ports.empty()) {
+        out << "{0}";
+    }
+    for (size_t i = 0; i < ports.size(); i++) {
+        out << (i ? ", " : "") << "{";
+        for (int p = 0; p < phases; p++) {
+            out << (p ? ", " : "") << ports[i]->get_rates()[p];
+        }
+        out << "}";
+    }
+    out << "};" << endl;
+}
+
+static void generate(ostream &out, const systemdata::System *system, const char *filename, bool schedule_only) {
+    out << "// Generated by sysgen from " << filename << ", do not edit" << endl;
+    out << "#include <iostream>" << endl;
+    out << "#include <fstream>" << endl;
+    out << "#include <cstdlib>" << endl;
+    out << "#include <unistd.h>" << endl;
+    out << "#include \"system/systemtables.h\"" << endl;
+    out << "#include \"system/systemvalidator.h\"" << endl;
+    if (schedule_only) {
+        out << "#include \"schedsim_main.h\"" << endl;
+    } else {
+        out << "#include <systemc.h>" << endl;
+        out << "#include \"systembuilder.h\"" << endl;
+        out << "#include \"sc_scheduler.h\"" << endl;
+        out << "#include \"sc_csdf_actor.h\"" << endl;
+        out << "#include \"fifo_fsl.h\"" << endl;
+        out << "#include \"statsmonitor.h\"" << endl;
+        out << "#include \"graspmonitor.h\"" << endl;
+    }
+    out << "using namespace std;" << endl;
+    out << "using namespace systemtables;" << endl << endl;
+    out << "namespace {" << endl << endl;
+
+    // Actor rate tables, also used by the port rows
+    const systemdata::EntityVector<systemdata::Actor> &actors = system->get_actors();
+    vector<vector<const systemdata::Actor::Port*> > inputs(actors.size()), outputs(actors.size());
+    for (size_t a = 0; a < actors.size(); a++) {
+        int phases = actors[a]->get_num_phases();
+        int max_rate = 0;
+        for (auto &port : actors[a]->get_ports()) {
+            (port.get_direction() == systemdata::PORT_IN ? inputs[a] : outputs[a]).push_back(&port);
+            for (int rate : port.get_rates()) {
+                max_rate = max(max_rate, rate);
+            }
+        }
+
+        out << "// Actor " << actors[a]->get_name() << endl;
+        out << "struct rates_" << a << " {" << endl;
+        out << "    static constexpr int phases = " << phases << ";" << endl;
+        out << "    static constexpr int inputs = " << inputs[a].size() << ";" << endl;
+        out << "    static constexpr int outputs = " << outputs[a].size() << ";" << endl;
+        out << "    static constexpr int max_rate = " << max_rate << ";" << endl;
+        emit_rate_table(out, "in", inputs[a], phases);
+        emit_rate_table(out, "out", outputs[a], phases);
+        out << "};" << endl;
+        out << "constexpr int rates_" << a << "::in[" << (inputs[a].empty() ? 1 : inputs[a].size()) << "][" << phases << "];" << endl;
+        out << "constexpr int rates_" << a << "::out[" << (outputs[a].empty() ? 1 : outputs[a].size()) << "][" << phases << "];" << endl << endl;
+    }
+
+    vector<string> rows;
+    vector<string> slot_rows;
+    for (auto s : system->get_schedulers()) {
+        string name = s->get_name();
+        ostringstream row;
+        row << "{" << quote(name) << ", " << algorithm_name(s->get_algorithm()) << ", " << type_name(s->get_type())
+            << ", " << quote(s->get_mapping()->get_name()) << "}";
+        rows.push_back(row.str());
+
+        for (auto &slot : s->get_slots()) {
+            ostringstream srow;
+            srow << "{" << quote(name) << ", " << quote(slot.get_processor_name()) << ", " << quote(slot.get_task_name())
+                 << ", " << slot.get_start() << ", " << slot.get_length() << "}";
+            slot_rows.push_back(srow.str());
+        }
+    }
+    emit_table(out, "SchedulerRow", "schedulers", rows, "{NULL, systemdata::SCHED_NULL, systemdata::SCHEDTYPE_GLOBAL, NULL}");
+    emit_table(out, "SlotRow", "slots", slot_rows, "{NULL, NULL, NULL, 0, 0}");
+
+    rows.clear();
+    for (auto t : system->get_tasks()) {
+        string name = t->get_name();
+        ostringstream row;
+        row << "{" << quote(name) << ", " << t->get_wcet() << ", " << t->get_read_delay() << ", " << t->get_write_delay()
+            << ", " << t->get_start_time() << ", " << t->get_period() << ", " << t->get_deadline() << ", " << t->get_priority()
+            << ", " << (t->get_type() == systemdata::TASKTYPE_FIXED ? "systemdata::TASKTYPE_FIXED" : "systemdata::TASKTYPE_MIGRATING") << "}";
+        rows.push_back(row.str());
+    }
+    emit_table(out, "TaskRow", "tasks", rows, "{NULL, 0, 0, 0, 0, 0, 0, 0, systemdata::TASKTYPE_FIXED}");
+
+    rows.clear();
+    for (auto p : system->get_processors()) {
+        string name = p->get_name();
+        rows.push_back("{" + quote(name) + ", " + quote(p->get_scheduler()->get_name()) + "}");
+    }
+    emit_table(out, "ProcessorRow", "processors", rows, "{NULL, NULL}");
+
+    rows.clear();
+    for (auto m : system->get_mappings()) {
+        string name = m->get_name();
+        string prefix = "{" + quote(name) + ", ";
+        if (m->get_entries().empty()) {
+            rows.push_back(prefix + "0, NULL, NULL}");
+        }
+        for (size_t e = 0; e < m->get_entries().size(); e++) {
+            auto &pe = m->get_entries()[e];
+            string entry = prefix + to_string(e) + ", " + quote(pe.get_processor()->get_name()) + ", ";
+            if (pe.get_task_entries().empty()) {
+                rows.push_back(entry + "NULL}");
+            }
+            for (auto &te : pe.get_task_entries()) {
+                rows.push_back(entry + quote(te.get_task()->get_name()) + "}");
+            }
+        }
+    }
+    emit_table(out, "MappingRow", "mappings", rows, "{NULL, 0, NULL, NULL}");
+
+    rows.clear();
+    for (auto f : system->get_fifos()) {
+        string name = f->get_name();
+        ostringstream row;
+        row << "{" << quote(name) << ", " << f->get_size() << ", " << f->get_read_latency() << ", "
+            << f->get_write_latency() << ", " << f->get_bandwidth() << "}";
+        rows.push_back(row.str());
+    }
+    emit_table(out, "FifoRow", "fifos", rows, "{NULL, 0, 0, 0, 0}");
+
+    rows.clear();
+    for (size_t a = 0; a < actors.size(); a++) {
+        string prefix = "{" + quote(actors[a]->get_name()) + ", ";
+        if (actors[a]->get_ports().empty()) {
+            rows.push_back(prefix + "NULL, NULL, systemdata::PORT_IN, NULL, 0}");
+        }
+        int in = 0, outp = 0;
+        for (auto &port : actors[a]->get_ports()) {
+            bool input = port.get_direction() == systemdata::PORT_IN;
+            ostringstream row;
+            row << prefix << quote(port.get_name()) << ", " << quote(port.get_fifo_name()) << ", "
+                << (input ? "systemdata::PORT_IN" : "systemdata::PORT_OUT") << ", rates_" << a
+                << (input ? "::in[" : "::out[") << (input ? in++ : outp++) << "], " << actors[a]->get_num_phases() << "}";
+            rows.push_back(row.str());
+        }
+    }
+    emit_table(out, "PortRow", "ports", rows, "{NULL, NULL, NULL, systemdata::PORT_IN, NULL, 0}");
+
+    out << "constexpr Tables tables = {" << endl;
+    out << "    schedulers, num_schedulers, slots, num_slots, tasks, num_tasks, processors, num_processors," << endl;
+    out << "    mappings, num_mappings, fifos, num_fifos, ports, num_ports" << endl;
+    out << "};" << endl << endl;
+    out << "}" << endl << endl;
+
+    if (schedule_only) {
+        out << "// Schedule-only simulator for this system, takes the options of schedsim.cc" << endl;
+        out << "int main(int argc, char *argv[])" << endl;
+        out << "{" << endl;
+        out << "    SchedsimOptions options;" << endl;
+        out << "    if (!parse_schedsim_options(argc, argv, false, options)) {" << endl;
+        out << "        return schedsim_exit_usage;" << endl;
+        out << "    }" << endl << endl;
+        out << "    systemdata::System *system = build_system(tables);" << endl;
+        out << "    SystemValidator sv(system);" << endl;
+        out << "    if (!sv.validate()) {" << endl;
+        out << "        delete system;" << endl;
+        out << "        return schedsim_exit_invalid;" << endl;
+        out << "    }" << endl << endl;
+        out << "    int ret = run_schedsim(system, options);" << endl;
+        out << "    delete system;" << endl;
+        out << "    return ret;" << endl;
+        out << "}" << endl;
+    } else {
+        out << "// SystemC simulator for this system, see test.cc" << endl;
+        out << "int sc_main(int argc, char *argv[])" << endl;
+        out << "{" << endl;
+        out << "    int simulation_time = -1;" << endl;
+        out << "    const char *stats_file = NULL;" << endl;
+        out << "    int opt;" << endl << endl;
+        out << "    while ((opt = getopt(argc, argv, \"s:\")) != -1) {" << endl;
+        out << "        switch (opt) {" << endl;
+        out << "            case 's':" << endl;
+        out << "                stats_file = optarg;" << endl;
+        out << "                break;" << endl;
+        out << "            default:" << endl;
+        out << "                cerr << \"Usage: \" << argv[0] << \" [-s stats-file] [simulation-time]\" << endl;" << endl;
+        out << "                return -1;" << endl;
+        out << "        }" << endl;
+        out << "    }" << endl << endl;
+        out << "    if (argc - optind > 1) {" << endl;
+        out << "        cerr << \"Usage: \" << argv[0] << \" [-s stats-file] [simulation-time]\" << endl;" << endl;
+        out << "        return -1;" << endl;
+        out << "    } else if (argc - optind == 1) {" << endl;
+        out << "        simulation_time = atoi(argv[optind]);" << endl;
+        out << "    }" << endl << endl;
+        out << "    systemdata::System *system = build_system(tables);" << endl;
+        out << "    SystemValidator sv(system);" << endl;
+        out << "    if (!sv.validate()) {" << endl;
+        out << "        delete system;" << endl;
+        out << "        return -2;" << endl;
+        out << "    }" << endl << endl;
+        out << "    sc_clock clk(\"sysclk\");" << endl << endl;
+        out << "    StatsMonitor statsmon;" << endl;
+        out << "    GraspMonitor graspmon(\"trace.grasp\");" << endl << endl;
+        out << "    sc_scheduler sched(\"sched\");" << endl;
+        out << "    sched.add_monitor(&statsmon);" << endl;
+        out << "    sched.add_monitor(&graspmon);" << endl;
+        out << "    sched.clk(clk);" << endl << endl;
+        out << "    SystemBuilder sb(system, &sched);" << endl << endl;
+        out << "    sc_trace_file *tf = sc_create_vcd_trace_file(\"trace\");" << endl;
+        out << "    sc_trace(tf, clk, \"Clock\");" << endl << endl;
+
+        // Fifos in order of first use, like NetworkBuilder
+        out << "    // Fifos" << endl;
+        unordered_map<string, int> fifo_ids;
+        for (auto actor : actors) {
+            for (auto &port : actor->get_ports()) {
+                string name = port.get_fifo_name();
+                if (fifo_ids.count(name)) continue;
+                int id = fifo_ids.size();
+                fifo_ids[name] = id;
+
+                const systemdata::Fifo *f = system->get_fifo(name);
+                if (!f) {
+                    cerr << "Warning: no size defined for fifo '" << name << "', assuming default value (" << default_fifo_size << ")" << endl;
+                }
+                out << "    event_fsl<int, " << (f ? f->get_read_latency() : 1) << ", " << (f ? f->get_write_latency() : 1)
+                    << "> fifo_" << id << "(" << quote(name) << ", " << (f ? f->get_size() : default_fifo_size) << ");" << endl;
+                out << "    fifo_" << id << ".clk(clk);" << endl;
+                if (f && f->get_bandwidth() != 1) {
+                    out << "    fifo_" << id << ".set_bandwidth(" << f->get_bandwidth() << ");" << endl;
+                }
+            }
+        }
+        out << endl;
+
+        out << "    // Actors" << endl;
+        for (size_t a = 0; a < actors.size(); a++) {
+            string name = quote(actors[a]->get_name());
+            string actor = "actor_" + to_string(a);
+            out << "    sc_static_csdf_actor<rates_" << a << "> " << actor << "(" << name << ", &sched);" << endl;
+            out << "    sb.create_task(" << name << ", &" << actor << ");" << endl;
+            out << "    sb.set_delays(" << name << ", &" << actor << ");" << endl;
+            out << "    " << actor << ".clk(clk);" << endl;
+            out << "    sc_signal<bool> " << actor << "_running;" << endl;
+            out << "    sc_trace(tf, " << actor << "_running, " << quote(actors[a]->get_name() + "_running") << ");" << endl;
+            out << "    " << actor << ".running(" << actor << "_running);" << endl;
+            for (size_t i = 0; i < inputs[a].size(); i++) {
+                out << "    " << actor << ".bind_input(" << i << ", fifo_" << fifo_ids[inputs[a][i]->get_fifo_name()] << ");" << endl;
+            }
+            for (size_t i = 0; i < outputs[a].size(); i++) {
+                out << "    " << actor << ".bind_output(" << i << ", fifo_" << fifo_ids[outputs[a][i]->get_fifo_name()] << ");" << endl;
+            }
+            out << endl;
+        }
+
+        out << "    sb.set_monitoring_parameters(&graspmon);" << endl;
+        out << "    sb.set_monitoring_parameters(&statsmon);" << endl << endl;
+        out << "    if (simulation_time == -1) {" << endl;
+        out << "        simulation_time = sb.get_default_simulation_time();" << endl;
+        out << "    }" << endl;
+        out << "    cout << \"Running simulation for \" << simulation_time << \" clock cycles\" << endl;" << endl;
+        out << "    sched.enable_fast_forward(simulation_time);" << endl << endl;
+        out << "    sc_start(simulation_time, SC_NS);" << endl << endl;
+        out << "    graspmon.simulation_finished();" << endl;
+        out << "    statsmon.simulation_finished();" << endl;
+        out << "    statsmon.write_stats(cerr);" << endl;
+        out << "    if (stats_file) {" << endl;
+        out << "        ofstream stats(stats_file);" << endl;
+        out << "        statsmon.write_stats_csv(stats);" << endl;
+        out << "    }" << endl << endl;
+        out << "    delete system;" << endl;
+        out << "    return 0;" << endl;
+        out << "}" << endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    SystemLoader sl;
+    bool schedule_only = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s")) != -1) {
+        switch (opt) {
+            case 's':
+                schedule_only = true;
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-s] <xml-file> <output-file>" << endl;
+                return -1;
+        }
+    }
+
+    if (argc - optind != 2) {
+        cerr << "Usage: " << argv[0] << " [-s] <xml-file> <output-file>" << endl;
+        return -1;
+    }
+
+    systemdata::System* system = sl.load(argv[optind]);
+    if (system) {
+        SystemValidator sv(system);
+        if (!sv.validate()) {
+            delete system;
+            return -2;
+        }
+    } else {
+        cerr << sl.get_errors();
+        return -3;
+    }
+
+    if (!schedule_only && system->get_actors().empty()) {
+        cerr << "No actors defined in " << argv[optind] << endl;
+        delete system;
+        return -2;
+    }
+
+    ofstream out(argv[optind + 1]);
+    if (!out) {
+        cerr << "Couldn't open file: " << argv[optind + 1] << endl;
+        delete system;
+        return -4;
+    }
+    generate(out, system, argv[optind], schedule_only);
+
+    delete system;
+    return 0;
+}
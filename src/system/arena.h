@@ -0,0 +1,149 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace systemdata {
+    // Bump allocator for the system model. Objects are never freed one by one:
+    // the chunks are released all at once when the arena is destroyed, after
+    // running the destructors of the few objects that need one.
+    class Arena {
+        static const size_t chunk_size = 64 * 1024;
+
+        std::vector<char*> chunks;
+        char *next;
+        char *end;
+        size_t allocated;
+        std::vector<std::pair<void (*)(void*), void*> > destructors;
+
+        template <class T>
+        static void destroy(void *object) {
+            static_cast<T*>(object)->~T();
+        }
+
+        static char *align_up(char *p, size_t align) {
+            return p + (align - reinterpret_cast<size_t>(p) % align) % align;
+        }
+
+        char *new_chunk(size_t length) {
+            char *chunk = static_cast<char*>(malloc(length));
+            if (!chunk) {
+                throw std::bad_alloc();
+            }
+            chunks.push_back(chunk);
+            return chunk;
+        }
+
+        public:
+        Arena() : next(NULL), end(NULL), allocated(0) {}
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena() {
+            for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) {
+                it->first(it->second);
+            }
+            for (auto chunk : chunks) {
+                free(chunk);
+            }
+        }
+
+        void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+            allocated += size;
+
+            char *ret = next ? align_up(next, align) : NULL;
+            if (!ret || ret > end || size > static_cast<size_t>(end - ret)) {
+                // Large blocks get a chunk of their own, the current chunk stays in use
+                if (size + align > chunk_size / 4) {
+                    return align_up(new_chunk(size + align), align);
+                }
+                next = new_chunk(chunk_size);
+                end = next + chunk_size;
+                ret = align_up(next, align);
+            }
+
+            next = ret + size;
+            return ret;
+        }
+
+        // Only blocks with a chunk of their own are returned to the system,
+        // like the buffers that a growing entity list leaves behind
+        void deallocate(void *block, size_t size, size_t align = alignof(std::max_align_t)) {
+            if (size + align <= chunk_size / 4) {
+                return;
+            }
+            for (auto it = chunks.begin(); it != chunks.end(); ++it) {
+                if (align_up(*it, align) == block) {
+                    free(*it);
+                    chunks.erase(it);
+                    allocated -= size;
+                    return;
+                }
+            }
+        }
+
+        template <class T, class... Args>
+        T *create(Args&&... args) {
+            T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            if (!std::is_trivially_destructible<T>::value) {
+                destructors.push_back(std::make_pair(&destroy<T>, static_cast<void*>(object)));
+            }
+            return object;
+        }
+
+        // Zero-terminated copy of a string
+        const char *copy(const char *s, size_t length) {
+            char *ret = static_cast<char*>(allocate(length + 1, 1));
+            memcpy(ret, s, length);
+            ret[length] = '\0';
+            return ret;
+        }
+
+        // Bytes handed out, without the unused tails of the chunks
+        size_t get_allocated() const {
+            return allocated;
+        }
+    };
+
+    // Allocator for standard containers whose nodes live in an arena
+    template <class T>
+    class ArenaAllocator {
+        template <class U> friend class ArenaAllocator;
+        Arena *arena;
+
+        public:
+        typedef T value_type;
+
+        explicit ArenaAllocator(Arena *arena) : arena(arena) {}
+
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+        T *allocate(size_t n) {
+            return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *p, size_t n) {
+            arena->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        template <class U>
+        bool operator==(const ArenaAllocator<U> &other) const {
+            return arena == other.arena;
+        }
+
+        template <class U>
+        bool operator!=(const ArenaAllocator<U> &other) const {
+            return arena != other.arena;
+        }
+    };
+}
+
+#endif // ARENA_H
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_set>
+#include "schedulabilityanalysis.h"
+using namespace std;
+
+SchedulabilityAnalysis::SchedulabilityAnalysis(systemdata::System *system) {
+    this->system = system;
+}
+
+const char *SchedulabilityAnalysis::verdict_name(Verdict verdict) {
+    switch (verdict) {
+        case FEASIBLE:
+            return "FEASIBLE";
+        case INFEASIBLE:
+            return "INFEASIBLE";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+SchedulabilityAnalysis::TaskParams SchedulabilityAnalysis::params(const systemdata::Task *task) {
+    TaskParams p;
+    p.wcet = task->get_wcet() + task->get_read_delay() + task->get_write_delay();
+    p.deadline = task->get_deadline();
+    p.period = task->get_period();
+    p.offset = task->get_start_time() != 0;
+    return p;
+}
+
+// Processor demand of the jobs with release and deadline in [0, t]
+long long SchedulabilityAnalysis::demand(const vector<TaskParams> &tasks, long long t) {
+    long long h = 0;
+    for (auto &task : tasks) {
+        if (task.deadline <= t) {
+            h += ((t - task.deadline) / task.period + 1) * task.wcet;
+        }
+    }
+    return h;
+}
+
+// Latest absolute deadline strictly before t, or -1 if there is none
+long long SchedulabilityAnalysis::last_deadline_before(const vector<TaskParams> &tasks, long long t) {
+    long long d = -1;
+    for (auto &task : tasks) {
+        if (task.deadline < t) {
+            long long k = (t - task.deadline - 1) / task.period;
+            d = max(d, k * task.period + task.deadline);
+        }
+    }
+    return d;
+}
+
+// Quick Processor-demand Analysis (Zhang and Burns), exact for synchronous task sets
+SchedulabilityAnalysis::Verdict SchedulabilityAnalysis::qpa(const vector<TaskParams> &tasks, string &test) {
+    test = "QPA";
+    if (tasks.empty()) {
+        return FEASIBLE;
+    }
+
+    double u = 0;
+    bool implicit = true;
+    bool offsets = false;
+    long long d_min = tasks[0].deadline;
+    long long d_max = 0;
+    for (auto &task : tasks) {
+        u += static_cast<double>(task.wcet) / task.period;
+        implicit = implicit && task.deadline == task.period;
+        offsets = offsets || task.offset;
+        d_min = min(d_min, task.deadline);
+        d_max = max(d_max, task.deadline);
+    }
+
+    if (u > 1.0 + 1e-12) {
+        test = "utilization";
+        return INFEASIBLE;
+    }
+    if (implicit) {
+        test = "utilization";
+        return FEASIBLE;
+    }
+
+    // Synchronous busy period
+    long long busy = 0;
+    for (auto &task : tasks) {
+        busy += task.wcet;
+    }
+    while (true) {
+        long long w = 0;
+        for (auto &task : tasks) {
+            w += (busy + task.period - 1) / task.period * task.wcet;
+        }
+        if (w == busy) {
+            break;
+        }
+        busy = w;
+    }
+
+    // Bound on the interval to check
+    long long limit = busy;
+    if (u < 1.0 - 1e-12) {
+        double la = 0;
+        for (auto &task : tasks) {
+            la += static_cast<double>(task.period - task.deadline) * task.wcet / task.period;
+        }
+        la /= 1.0 - u;
+        long long l = max(d_max, static_cast<long long>(ceil(la)));
+        limit = min(limit, l);
+    }
+
+    long long t = last_deadline_before(tasks, limit + 1);
+    long long h = demand(tasks, t);
+    while (h <= t && h > d_min) {
+        if (h < t) {
+            t = h;
+        } else {
+            t = last_deadline_before(tasks, t);
+        }
+        h = demand(tasks, t);
+    }
+
+    if (h <= d_min) {
+        return FEASIBLE;
+    }
+
+    // With offsets the synchronous case is only a worst case
+    return offsets ? UNKNOWN : INFEASIBLE;
+}
+
+// Sufficient density test for global EDF (Goossens, Funk and Baruah)
+SchedulabilityAnalysis::Verdict SchedulabilityAnalysis::gfb(const vector<TaskParams> &tasks, int processors, string &test) {
+    double u = 0, density = 0, density_max = 0;
+    for (auto &task : tasks) {
+        double d = static_cast<double>(task.wcet) / min(task.deadline, task.period);
+        u += static_cast<double>(task.wcet) / task.period;
+        density += d;
+        density_max = max(density_max, d);
+    }
+
+    if (u > processors + 1e-12) {
+        test = "utilization";
+        return INFEASIBLE;
+    }
+
+    test = "GFB";
+    if (density <= processors - (processors - 1) * density_max + 1e-12) {
+        return FEASIBLE;
+    }
+    return UNKNOWN;
+}
+
+vector<SchedulabilityAnalysis::Result> SchedulabilityAnalysis::analyse() {
+    vector<Result> results;
+
+    for (auto scheduler : system->get_schedulers()) {
+        const systemdata::Mapping *mapping = scheduler->get_mapping();
+        bool edf = scheduler->get_algorithm() == systemdata::SCHED_EDF ||
+                   (scheduler->get_algorithm() == systemdata::SCHED_STATIC && scheduler->get_slots().empty());
+
+        if (edf && scheduler->get_type() == systemdata::SCHEDTYPE_GLOBAL) {
+            // One verdict for all processors of the scheduler
+            auto start = chrono::steady_clock::now();
+            vector<TaskParams> tasks;
+            vector<string> names;
+            unordered_set<const systemdata::Task*> seen;
+            for (auto &pe : mapping->get_entries()) {
+                names.push_back(pe.get_processor()->get_name());
+                for (auto &te : pe.get_task_entries()) {
+                    // Global mappings usually list every task for every processor
+                    if (seen.insert(te.get_task()).second) {
+                        tasks.push_back(params(te.get_task()));
+                    }
+                }
+            }
+            string test;
+            Verdict verdict = gfb(tasks, names.size(), test);
+            double time_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+            for (auto &name : names) {
+                Result r = { name, scheduler->get_name(), test, verdict, time_us };
+                results.push_back(r);
+            }
+            continue;
+        }
+
+        for (auto &pe : mapping->get_entries()) {
+            auto start = chrono::steady_clock::now();
+            Result r;
+            r.processor = pe.get_processor()->get_name();
+            r.scheduler = scheduler->get_name();
+            r.test = "none";
+            r.verdict = UNKNOWN;
+
+            if (edf && scheduler->get_type() == systemdata::SCHEDTYPE_PARTITIONED) {
+                vector<TaskParams> tasks;
+                for (auto &te : pe.get_task_entries()) {
+                    tasks.push_back(params(te.get_task()));
+                }
+                r.verdict = qpa(tasks, r.test);
+            }
+
+            r.time_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+            results.push_back(r);
+        }
+    }
+
+    return results;
+}
@@ -0,0 +1,52 @@
+#ifndef SCHEDULABILITYANALYSIS_H
+#define SCHEDULABILITYANALYSIS_H
+
+#include <string>
+#include <vector>
+#include "systemdata.h"
+
+// Analytic schedulability tests on a validated system, so that obviously
+// infeasible configurations can be rejected without simulating them.
+// Partitioned EDF (and static tables, which are generated by EDF) get the
+// exact processor-demand test using Quick Processor-demand Analysis, global
+// EDF gets the sufficient GFB density test. Other schedulers are UNKNOWN.
+class SchedulabilityAnalysis {
+public:
+    enum Verdict {
+        FEASIBLE,
+        INFEASIBLE,
+        UNKNOWN
+    };
+
+    struct Result {
+        std::string processor;
+        std::string scheduler;
+        std::string test;
+        Verdict verdict;
+        double time_us;         // Time spent in the analysis
+    };
+
+private:
+    struct TaskParams {
+        long long wcet;         // Including read and write delays
+        long long deadline;
+        long long period;
+        bool offset;            // Not released at time 0
+    };
+
+    systemdata::System *system;
+
+    static Verdict qpa(const std::vector<TaskParams> &tasks, std::string &test);
+    static Verdict gfb(const std::vector<TaskParams> &tasks, int processors, std::string &test);
+    static long long demand(const std::vector<TaskParams> &tasks, long long t);
+    static long long last_deadline_before(const std::vector<TaskParams> &tasks, long long t);
+    static TaskParams params(const systemdata::Task *task);
+
+public:
+    SchedulabilityAnalysis(systemdata::System *system);
+    std::vector<Result> analyse();
+
+    static const char *verdict_name(Verdict verdict);
+};
+
+#endif // SCHEDULABILITYANALYSIS_H
@@ -0,0 +1,386 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include "streamingsystemloader.h"
+#include "xmlsupport.h"
+using namespace std;
+
+// Line of the current element; the parser itself may already be further
+int StreamingSystemLoader::line() {
+    return xmlGetLineNo(xmlTextReaderCurrentNode(reader));
+}
+
+const char *StreamingSystemLoader::elementName() {
+    return reinterpret_cast<const char*>(xmlTextReaderConstName(reader));
+}
+
+// Value of an attribute of the current element, valid until the next read
+const char *StreamingSystemLoader::getAttribute(const char *attribute_name, bool required) {
+    if (xmlTextReaderMoveToAttribute(reader, BAD_CAST attribute_name) != 1) {
+        if (required) {
+            errors << "Missing attribute '" << attribute_name << "' for element '" << elementName() << "' on line " << line() << endl;
+        }
+        return NULL;
+    }
+
+    const char *value = reinterpret_cast<const char*>(xmlTextReaderConstValue(reader));
+    xmlTextReaderMoveToElement(reader);
+    return value ? value : "";
+}
+
+bool StreamingSystemLoader::getAttributeValue(const char *attribute_name, string &attribute_value) {
+    const char *value = getAttribute(attribute_name);
+    if (!value) {
+        return false;
+    }
+
+    attribute_value = value;
+    return true;
+}
+
+// Without required, a missing attribute leaves attribute_value unchanged
+bool StreamingSystemLoader::getAttributeValue(const char *attribute_name, int &attribute_value, bool required) {
+    const char *value = getAttribute(attribute_name, required);
+    if (!value) {
+        return !required;
+    }
+
+    return parseInt(attribute_name, value, attribute_value);
+}
+
+// Accepts what stoi() accepts in SystemLoader, up to the first character that
+// is not part of the number
+static bool to_int(const char *value, const char **end, int &result) {
+    char *e;
+    errno = 0;
+    long l = strtol(value, &e, 10);
+    if (e == value || errno == ERANGE || l < INT_MIN || l > INT_MAX) {
+        return false;
+    }
+
+    *end = e;
+    result = l;
+    return true;
+}
+
+bool StreamingSystemLoader::parseInt(const char *attribute_name, const char *value, int &result) {
+    const char *end;
+    if (!to_int(value, &end, result)) {
+        errors << "Invalid argument for " << attribute_name << " on line " << line() << ": " << value << endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Comma-separated list of rates, one per phase
+bool StreamingSystemLoader::parseRates(const char *value, vector<int> &rates) {
+    const char *begin = value;
+    while (true) {
+        const char *end;
+        int rate;
+        if (!to_int(begin, &end, rate)) {
+            errors << "Invalid argument for rates on line " << line() << ": " << value << endl;
+            return false;
+        }
+        rates.push_back(rate);
+
+        begin = strchr(end, ',');
+        if (!begin) break;
+        begin++;
+    }
+
+    return true;
+}
+
+systemdata::Scheduler *StreamingSystemLoader::processScheduler() {
+    string scheduler_name, mapping_name;
+    systemdata::SchedulerType type;
+    systemdata::Algorithm algorithm;
+
+    const char *algorithm_name, *type_name;
+    if (!getAttributeValue("name", scheduler_name) ||
+        !(algorithm_name = getAttribute("algorithm")) ||
+        !(type_name = getAttribute("type")) ||
+        !getAttributeValue("mapping", mapping_name)) {
+        return NULL;
+    }
+
+    if (strcmp(algorithm_name, "null") == 0) {
+        algorithm = systemdata::SCHED_NULL;
+    } else if (strcmp(algorithm_name, "static") == 0) {
+        algorithm = systemdata::SCHED_STATIC;
+    } else if (strcmp(algorithm_name, "EDF") == 0) {
+        algorithm = systemdata::SCHED_EDF;
+    } else if (strcmp(algorithm_name, "FP") == 0) {
+        algorithm = systemdata::SCHED_FP;
+    } else {
+        errors << "Invalid algorithm: " << algorithm_name << " for scheduler " << scheduler_name << endl;
+        return NULL;
+    }
+
+    if (strcmp(type_name, "global") == 0) {
+        type = systemdata::SCHEDTYPE_GLOBAL;
+    } else if (strcmp(type_name, "partitioned") == 0) {
+        type = systemdata::SCHEDTYPE_PARTITIONED;
+    } else if (strcmp(type_name, "hybrid-semipartitioned") == 0) {
+        type = systemdata::SCHEDTYPE_HYBRID;
+    } else {
+        errors << "Invalid scheduler type: " << type_name << " for scheduler " << scheduler_name << endl;
+        return NULL;
+    }
+
+    return system->createScheduler(scheduler_name, algorithm, type, mapping_name);
+}
+
+bool StreamingSystemLoader::processSlot(systemdata::Scheduler *scheduler) {
+    string processor_name, task_name;
+    int start, length;
+    if (!getAttributeValue("processor", processor_name) ||
+        !getAttributeValue("task", task_name) ||
+        !getAttributeValue("start", start) ||
+        !getAttributeValue("length", length)) {
+        return false;
+    }
+
+    scheduler->add_slot(processor_name, task_name, start, length);
+    return true;
+}
+
+systemdata::Task *StreamingSystemLoader::processTask() {
+    string task_name;
+    int wcet, read_delay, write_delay, start_time, period, deadline, priority;
+    systemdata::TaskType type;
+
+    const char *type_name;
+    if (!getAttributeValue("name", task_name) ||
+        !getAttributeValue("wcet", wcet) ||
+        !getAttributeValue("readDelay", read_delay) ||
+        !getAttributeValue("writeDelay", write_delay) ||
+        !getAttributeValue("startTime", start_time) ||
+        !getAttributeValue("period", period) ||
+        !getAttributeValue("deadline", deadline) ||
+        !getAttributeValue("priority", priority) ||
+        !(type_name = getAttribute("type"))) {
+        return NULL;
+    }
+
+    if (strcmp(type_name, "fixed") == 0) {
+        type = systemdata::TASKTYPE_FIXED;
+    } else if (strcmp(type_name, "migrating") == 0) {
+        type = systemdata::TASKTYPE_MIGRATING;
+    } else {
+        errors << "Invalid task type: " << type_name << " for task " << task_name << endl;
+        return NULL;
+    }
+
+    return system->createTask(task_name, wcet, read_delay, write_delay, start_time, period, deadline, priority, type);
+}
+
+systemdata::Processor *StreamingSystemLoader::processProcessor() {
+    string processor_name, scheduler_name;
+    if (!getAttributeValue("name", processor_name) ||
+        !getAttributeValue("scheduler", scheduler_name)) {
+        return NULL;
+    }
+
+    return system->createProcessor(processor_name, scheduler_name);
+}
+
+systemdata::Fifo *StreamingSystemLoader::processFifo() {
+    string name;
+    int size;
+    int read_latency = 1, write_latency = 1, bandwidth = 1;
+    if (!getAttributeValue("name", name) ||
+        !getAttributeValue("size", size)) {
+        return NULL;
+    }
+
+    // Latencies and bandwidth are optional
+    if (!getAttributeValue("readLatency", read_latency, false) ||
+        !getAttributeValue("writeLatency", write_latency, false) ||
+        !getAttributeValue("bandwidth", bandwidth, false)) {
+        return NULL;
+    }
+
+    return system->createFifo(name, size, read_latency, write_latency, bandwidth);
+}
+
+systemdata::Mapping *StreamingSystemLoader::processMapping() {
+    string name;
+    if (!getAttributeValue("name", name)) {
+        return NULL;
+    }
+
+    return system->createMapping(name);
+}
+
+systemdata::Mapping::ProcessorEntry *StreamingSystemLoader::processMappingProcessor(systemdata::Mapping *mapping) {
+    string processor_name;
+    if (!getAttributeValue("name", processor_name)) {
+        return NULL;
+    }
+
+    return mapping->add_entry(processor_name);
+}
+
+bool StreamingSystemLoader::processMappingTask(systemdata::Mapping::ProcessorEntry *entry) {
+    string task_name;
+    if (!getAttributeValue("name", task_name)) {
+        return false;
+    }
+
+    entry->add_task(task_name);
+    return true;
+}
+
+systemdata::Actor *StreamingSystemLoader::processActor() {
+    string name;
+    if (!getAttributeValue("name", name)) {
+        return NULL;
+    }
+
+    return system->createActor(name);
+}
+
+bool StreamingSystemLoader::processPort(systemdata::Actor *actor) {
+    string port_name, fifo_name;
+    systemdata::PortDirection direction;
+    vector<int> rates;
+
+    const char *direction_name, *rates_value;
+    if (!getAttributeValue("name", port_name) ||
+        !getAttributeValue("fifo", fifo_name) ||
+        !(direction_name = getAttribute("direction")) ||
+        !(rates_value = getAttribute("rates")) ||
+        !parseRates(rates_value, rates)) {
+        return false;
+    }
+
+    if (strcmp(direction_name, "in") == 0) {
+        direction = systemdata::PORT_IN;
+    } else if (strcmp(direction_name, "out") == 0) {
+        direction = systemdata::PORT_OUT;
+    } else {
+        errors << "Invalid direction: " << direction_name << " for port " << port_name << " of actor " << actor->get_name() << endl;
+        return false;
+    }
+
+    actor->add_port(port_name, fifo_name, direction, rates);
+    return true;
+}
+
+// Elements are added to the system as soon as their start tag is read, and
+// their children are added to them afterwards
+bool StreamingSystemLoader::read(const string &filename) {
+    systemdata::Scheduler *scheduler = NULL;
+    systemdata::Mapping *mapping = NULL;
+    systemdata::Mapping::ProcessorEntry *entry = NULL;
+    systemdata::Actor *actor = NULL;
+    int ret;
+
+    while ((ret = xmlTextReaderRead(reader)) == 1) {
+        if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) continue;
+
+        int depth = xmlTextReaderDepth(reader);
+        const char *name = elementName();
+
+        if (depth == 1) {
+            bool ok;
+            scheduler = NULL;
+            mapping = NULL;
+            entry = NULL;
+            actor = NULL;
+
+            if (strcmp(name, "scheduler") == 0) {
+                ok = system->addScheduler(scheduler = processScheduler());
+            } else if (strcmp(name, "task") == 0) {
+                ok = system->addTask(processTask());
+            } else if (strcmp(name, "processor") == 0) {
+                ok = system->addProcessor(processProcessor());
+            } else if (strcmp(name, "fifo") == 0) {
+                ok = system->addFifo(processFifo());
+            } else if (strcmp(name, "mapping") == 0) {
+                ok = system->addMapping(mapping = processMapping());
+            } else if (strcmp(name, "actor") == 0) {
+                ok = system->addActor(actor = processActor());
+            } else {
+                errors << "Unsupported element: '" << name << "'" << endl;
+                return false;
+            }
+
+            if (!ok) {
+                return false;
+            }
+        } else if (depth == 2) {
+            // Elements that have no children in the format ignore them, like SystemLoader
+            entry = NULL;
+            if (!scheduler && !mapping && !actor) continue;
+
+            const char *child = scheduler ? "slot" : mapping ? "processor" : "port";
+            if (strcmp(name, child) != 0) {
+                errors << "Invalid element '" << name << "' on line " << line() << endl;
+                return false;
+            }
+
+            if (scheduler) {
+                if (!processSlot(scheduler)) return false;
+            } else if (mapping) {
+                if (!(entry = processMappingProcessor(mapping))) return false;
+            } else {
+                if (!processPort(actor)) return false;
+            }
+        } else if (depth == 3 && entry) {
+            if (strcmp(name, "task") != 0) {
+                errors << "Invalid element '" << name << "' on line " << line() << endl;
+                return false;
+            }
+            if (!processMappingTask(entry)) {
+                return false;
+            }
+        }
+    }
+
+    if (ret != 0) {
+        errors << "Couldn't open file: " << filename << endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Errors of the parser go to the loader instead of libxml2's global handler
+void StreamingSystemLoader::reader_error(void *loader, XmlError error) {
+    if (error->level >= XML_ERR_ERROR) {
+        write_xml_error(static_cast<StreamingSystemLoader*>(loader)->errors, error);
+    }
+}
+
+systemdata::System *StreamingSystemLoader::load(const string &filename) {
+    init_libxml();
+    errors.str("");
+
+    // Whitespace between elements is skipped by the parser instead of being returned as nodes
+    reader = xmlReaderForFile(filename.c_str(), NULL, XML_PARSE_NOBLANKS | XML_PARSE_COMPACT | XML_PARSE_NOWARNING);
+    if (!reader) {
+        errors << "Couldn't open file: " << filename << endl;
+        return NULL;
+    }
+    xmlTextReaderSetStructuredErrorHandler(reader, reader_error, this);
+
+    system = new systemdata::System();
+    if (!read(filename)) {
+        delete system;
+        system = NULL;
+    }
+
+    xmlFreeTextReader(reader);
+    reader = NULL;
+
+    systemdata::System *ret = system;
+    system = NULL;
+    return ret;
+}
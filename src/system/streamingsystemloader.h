@@ -0,0 +1,52 @@
+#ifndef STREAMINGSYSTEMLOADER_H
+#define STREAMINGSYSTEMLOADER_H
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <libxml/xmlreader.h>
+#include "systemdata.h"
+#include "xmlsupport.h"
+
+// Loads the same files as SystemLoader, but reads them with an xmlTextReader
+// in a single pass instead of building the whole document tree first. Only
+// the current element is in memory, and attribute values are parsed straight
+// from the reader's buffer. Like SystemLoader, an instance loads one file at
+// a time, and instances can be used from several threads at once.
+class StreamingSystemLoader {
+    xmlTextReaderPtr reader;
+    systemdata::System *system;         // While loading
+    std::ostringstream errors;
+
+    const char *getAttribute(const char *attribute_name, bool required = true);
+    bool getAttributeValue(const char *attribute_name, std::string &attribute_value);
+    bool getAttributeValue(const char *attribute_name, int &attribute_value, bool required = true);
+    bool parseInt(const char *attribute_name, const char *value, int &result);
+    bool parseRates(const char *value, std::vector<int> &rates);
+    int line();
+    const char *elementName();
+
+    systemdata::Scheduler *processScheduler();
+    bool processSlot(systemdata::Scheduler *scheduler);
+    systemdata::Task *processTask();
+    systemdata::Processor *processProcessor();
+    systemdata::Fifo *processFifo();
+    systemdata::Mapping *processMapping();
+    systemdata::Mapping::ProcessorEntry *processMappingProcessor(systemdata::Mapping *mapping);
+    bool processMappingTask(systemdata::Mapping::ProcessorEntry *entry);
+    systemdata::Actor *processActor();
+    bool processPort(systemdata::Actor *actor);
+    bool read(const std::string &filename);
+    static void reader_error(void *loader, XmlError error);
+
+public:
+    // NULL on errors, which are then described by get_errors()
+    systemdata::System *load(const std::string &filename);
+
+    // Messages of the last load, one per line
+    std::string get_errors() const {
+        return errors.str();
+    }
+};
+
+#endif // STREAMINGSYSTEMLOADER_H
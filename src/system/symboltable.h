@@ -0,0 +1,125 @@
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "arena.h"
+
+namespace systemdata {
+    // Interned name: every name is stored once, and equal names share one
+    // Symbol, so they compare by pointer. Ids are dense, in order of interning.
+    // The characters follow the Symbol in the arena.
+    struct Symbol {
+        unsigned length;
+        int id;
+
+        const char *get_chars() const {
+            return reinterpret_cast<const char*>(this + 1);
+        }
+
+        std::string get_name() const {
+            return std::string(get_chars(), length);
+        }
+    };
+
+    inline std::ostream &operator<<(std::ostream &os, const Symbol &symbol) {
+        return os.write(symbol.get_chars(), symbol.length);
+    }
+
+    // For hash maps keyed by symbols, which are unique per name
+    struct SymbolHash {
+        size_t operator()(const Symbol *symbol) const noexcept {
+            return symbol->id;
+        }
+    };
+
+    // Open-addressing hash set of symbols. A slot holds the low bits of the
+    // hash and the id of a symbol, so probing only touches a symbol when its
+    // hash matches.
+    class SymbolTable {
+        struct Slot {
+            unsigned hash;
+            int id;             // -1 for an empty slot
+        };
+
+        Arena *arena;
+        std::vector<Slot> slots;        // Power of two, at most half full
+        std::vector<Symbol*> symbols;   // Indexed by id
+
+        size_t slot_for(const std::string &name, size_t hash) const {
+            size_t mask = slots.size() - 1;
+            size_t i = hash & mask;
+            while (slots[i].id >= 0) {
+                const Symbol *symbol = symbols[slots[i].id];
+                if (slots[i].hash == static_cast<unsigned>(hash) && symbol->length == name.size() &&
+                    memcmp(symbol->get_chars(), name.data(), name.size()) == 0) {
+                    break;
+                }
+                i = (i + 1) & mask;
+            }
+            return i;
+        }
+
+        void grow() {
+            Slot empty = { 0, -1 };
+            std::vector<Slot> old(slots.size() * 2, empty);
+            old.swap(slots);
+            size_t mask = slots.size() - 1;
+            for (auto &slot : old) {
+                if (slot.id < 0) continue;
+                size_t i = slot.hash & mask;
+                while (slots[i].id >= 0) {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = slot;
+            }
+        }
+
+        public:
+        SymbolTable(Arena *arena) : arena(arena) {
+            Slot empty = { 0, -1 };
+            slots.assign(64, empty);
+        }
+
+        const Symbol *intern(const std::string &name) {
+            size_t hash = std::hash<std::string>()(name);
+            size_t i = slot_for(name, hash);
+            if (slots[i].id >= 0) {
+                return symbols[slots[i].id];
+            }
+
+            Symbol *symbol = static_cast<Symbol*>(arena->allocate(sizeof(Symbol) + name.size() + 1, alignof(Symbol)));
+            symbol->length = name.size();
+            symbol->id = symbols.size();
+            memcpy(symbol + 1, name.c_str(), name.size() + 1);
+
+            slots[i].hash = hash;
+            slots[i].id = symbol->id;
+            symbols.push_back(symbol);
+
+            if (2 * symbols.size() > slots.size()) {
+                grow();
+            }
+            return symbol;
+        }
+
+        // NULL if the name was never interned
+        const Symbol *find(const std::string &name) const {
+            size_t i = slot_for(name, std::hash<std::string>()(name));
+            return slots[i].id >= 0 ? symbols[slots[i].id] : NULL;
+        }
+
+        const Symbol *get(int id) const {
+            return symbols[id];
+        }
+
+        int size() const {
+            return symbols.size();
+        }
+    };
+}
+
+#endif // SYMBOLTABLE_H
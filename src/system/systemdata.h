@@ -1,13 +1,17 @@
 #ifndef SYSTEMDATA_H
 #define SYSTEMDATA_H
 
-#include <unordered_map>
+#include <string>
+#include <vector>
+#include "arena.h"
+#include "symboltable.h"
 
-class SystemLoader;
 class SystemValidator;
+class SystemSnapshot;
 
 namespace systemdata {
     class Mapping;
+    class Processor;
 
     enum SchedulerType {
         SCHEDTYPE_GLOBAL,
@@ -18,7 +22,8 @@ namespace systemdata {
     enum Algorithm {
         SCHED_NULL,
         SCHED_STATIC,
-        SCHED_EDF
+        SCHED_EDF,
+        SCHED_FP
     };
 
     enum TaskType {
@@ -26,22 +31,67 @@ namespace systemdata {
         TASKTYPE_MIGRATING
     };
 
+    enum PortDirection {
+        PORT_IN,
+        PORT_OUT
+    };
+
+    // All entities are created by System in its arena, and their names are
+    // interned in its symbol table
+
     class Scheduler {
+        friend class System;
         friend class ::SystemValidator;
-        std::string name;
+        friend class ::SystemSnapshot;
+
+        public:
+        // Entry of an explicit dispatch table for a static scheduler
+        class Slot {
+            friend class ::SystemValidator;
+            friend class ::SystemSnapshot;
+            const Symbol *processor_name;
+            const Symbol *task_name;
+            int start;
+            int length;
+
+            public:
+            Slot(const Symbol *processor_name, const Symbol *task_name, int start, int length) :
+                processor_name(processor_name), task_name(task_name), start(start), length(length) {}
+
+            std::string get_processor_name() const {
+                return processor_name->get_name();
+            }
+
+            std::string get_task_name() const {
+                return task_name->get_name();
+            }
+
+            int get_start() const {
+                return start;
+            }
+
+            int get_length() const {
+                return length;
+            }
+        };
+
+        private:
+        SymbolTable *symbols;
+        const Symbol *name;
         Algorithm algorithm;
         SchedulerType type;
-        std::string mapping_name;
+        const Symbol *mapping_name;
         Mapping *mapping;
+        std::vector<Slot> slots;
 
         public:
-        Scheduler(const std::string &name, Algorithm algorithm,
-                  SchedulerType type, const std::string &mapping_name) :
-                      name(name), algorithm(algorithm), type(type),
-                      mapping_name(mapping_name) {}
+        Scheduler(SymbolTable *symbols, const Symbol *name, Algorithm algorithm,
+                  SchedulerType type, const Symbol *mapping_name) :
+                      symbols(symbols), name(name), algorithm(algorithm), type(type),
+                      mapping_name(mapping_name), mapping(NULL) {}
 
         std::string get_name() const {
-            return name;
+            return name->get_name();
         }
 
         Algorithm get_algorithm() const {
@@ -55,11 +105,21 @@ namespace systemdata {
         SchedulerType get_type() const {
             return type;
         }
+
+        const std::vector<Slot>& get_slots() const {
+            return slots;
+        }
+
+        void add_slot(const std::string &processor_name, const std::string &task_name, int start, int length) {
+            slots.push_back(Slot(symbols->intern(processor_name), symbols->intern(task_name), start, length));
+        }
     };
 
     class Task {
+        friend class System;
         friend class ::SystemValidator;
-        std::string name;
+        friend class ::SystemSnapshot;
+        const Symbol *name;
         int wcet;
         int read_delay;
         int write_delay;
@@ -68,18 +128,20 @@ namespace systemdata {
         int deadline;
         int priority;
         TaskType type;
+        Mapping *mapping;       // Set by SystemValidator
+        Processor *processor;
 
         public:
-        Task(const std::string &name, int wcet, int read_delay,
+        Task(const Symbol *name, int wcet, int read_delay,
              int write_delay, int start_time, int period, int deadline,
              int priority, TaskType type) :
                  name(name), wcet(wcet), read_delay(read_delay),
                  write_delay(write_delay), start_time(start_time),
-                 period(period), deadline(deadline), priority(priority), 
-                 type(type) {}
+                 period(period), deadline(deadline), priority(priority),
+                 type(type), mapping(NULL), processor(NULL) {}
 
         std::string get_name() const {
-            return name;
+            return name->get_name();
         }
 
         int get_wcet() const {
@@ -109,21 +171,36 @@ namespace systemdata {
         int get_priority() const {
             return priority;
         }
+
+        TaskType get_type() const {
+            return type;
+        }
+
+        // Mapping in which the task appears
+        Mapping* get_mapping() const {
+            return mapping;
+        }
+
+        // First processor the task is mapped to, the only one unless it is migrating
+        Processor* get_processor() const {
+            return processor;
+        }
     };
 
     class Processor {
-        friend class ::SystemLoader;
+        friend class System;
         friend class ::SystemValidator;
-        std::string name;
-        std::string scheduler_name;
+        friend class ::SystemSnapshot;
+        const Symbol *name;
+        const Symbol *scheduler_name;
         Scheduler *scheduler;
 
         public:
-        Processor(const std::string &name, const std::string &scheduler_name) :
-            name(name), scheduler_name(scheduler_name) {};
+        Processor(const Symbol *name, const Symbol *scheduler_name) :
+            name(name), scheduler_name(scheduler_name), scheduler(NULL) {};
 
         std::string get_name() const {
-            return name;
+            return name->get_name();
         }
 
         Scheduler *get_scheduler() const {
@@ -132,15 +209,19 @@ namespace systemdata {
     };
 
     class Mapping {
-        friend class ::SystemLoader;
+        friend class System;
         friend class ::SystemValidator;
+        friend class ::SystemSnapshot;
+
+        public:
         class TaskEntry {
             friend class ::SystemValidator;
-            std::string task_name;
+            friend class ::SystemSnapshot;
+            const Symbol *task_name;
             Task* task;
 
             public:
-            TaskEntry(const std::string &task_name) : task_name(task_name) {};
+            TaskEntry(const Symbol *task_name) : task_name(task_name), task(NULL) {};
 
             const Task* get_task() const {
                 return task;
@@ -148,151 +229,312 @@ namespace systemdata {
         };
 
         class ProcessorEntry {
-            friend class ::SystemLoader;
             friend class ::SystemValidator;
-            std::string processor_name;
+            friend class ::SystemSnapshot;
+            SymbolTable *symbols;
+            const Symbol *processor_name;
             Processor *processor;
-            std::vector<TaskEntry*> tasks;
+            std::vector<TaskEntry> tasks;
 
             public:
-            ProcessorEntry(const std::string &processor_name) :
-                processor_name(processor_name) {};
-
-            ~ProcessorEntry() {
-                for (auto it : tasks) {
-                    delete it;
-                }
-            }
+            ProcessorEntry(SymbolTable *symbols, const Symbol *processor_name) :
+                symbols(symbols), processor_name(processor_name), processor(NULL) {};
 
             const Processor* get_processor() const {
                 return processor;
             }
 
-            const std::vector<TaskEntry*>& get_task_entries() const {
+            const std::vector<TaskEntry>& get_task_entries() const {
                 return tasks;
             }
+
+            void add_task(const std::string &task_name) {
+                tasks.push_back(TaskEntry(symbols->intern(task_name)));
+            }
         };
 
-        std::string name;
-        std::vector<ProcessorEntry*> entries;
+        private:
+        SymbolTable *symbols;
+        const Symbol *name;
+        std::vector<ProcessorEntry> entries;
+        Scheduler *scheduler;   // Set by SystemValidator
 
         public:
+        Mapping(SymbolTable *symbols, const Symbol *name) :
+            symbols(symbols), name(name), scheduler(NULL) {}
+
         std::string get_name() const {
-            return name;
+            return name->get_name();
         }
 
-        const std::vector<ProcessorEntry*>& get_entries() const {
-            return entries;
+        // Scheduler that uses this mapping
+        Scheduler* get_scheduler() const {
+            return scheduler;
         }
 
-        ~Mapping() {
-            for (auto it : entries) {
-                delete it;
-            }
+        // Valid until the next entry is added
+        ProcessorEntry* add_entry(const std::string &processor_name) {
+            entries.push_back(ProcessorEntry(symbols, symbols->intern(processor_name)));
+            return &entries.back();
+        }
+
+        const std::vector<ProcessorEntry>& get_entries() const {
+            return entries;
         }
     };
 
     class Fifo {
-        std::string name;
+        friend class System;
+        friend class ::SystemValidator;
+        friend class ::SystemSnapshot;
+        const Symbol *name;
         int size;
+        int read_latency;       // Cycles until a read is accounted
+        int write_latency;      // Cycles until a written token is in the buffer
+        int bandwidth;          // Tokens per cycle of a burst
 
         public:
-        Fifo(const std::string &name, int size) : name(name), size(size) {}
+        Fifo(const Symbol *name, int size, int read_latency = 1, int write_latency = 1, int bandwidth = 1)
+            : name(name), size(size), read_latency(read_latency), write_latency(write_latency), bandwidth(bandwidth) {}
 
         std::string get_name() const {
-            return name;
+            return name->get_name();
         }
 
         int get_size() const {
             return size;
         }
+
+        int get_read_latency() const {
+            return read_latency;
+        }
+
+        int get_write_latency() const {
+            return write_latency;
+        }
+
+        int get_bandwidth() const {
+            return bandwidth;
+        }
+    };
+
+    // Cyclo-static dataflow actor, executed as the task with the same name
+    class Actor {
+        friend class System;
+        friend class ::SystemValidator;
+        friend class ::SystemSnapshot;
+
+        public:
+        // Connection to a fifo, with the number of tokens transferred in each phase
+        class Port {
+            friend class ::SystemValidator;
+            friend class ::SystemSnapshot;
+            const Symbol *name;
+            const Symbol *fifo_name;
+            PortDirection direction;
+            std::vector<int> rates;
+
+            public:
+            Port(const Symbol *name, const Symbol *fifo_name, PortDirection direction, const std::vector<int> &rates) :
+                name(name), fifo_name(fifo_name), direction(direction), rates(rates) {}
+
+            std::string get_name() const {
+                return name->get_name();
+            }
+
+            std::string get_fifo_name() const {
+                return fifo_name->get_name();
+            }
+
+            PortDirection get_direction() const {
+                return direction;
+            }
+
+            const std::vector<int>& get_rates() const {
+                return rates;
+            }
+        };
+
+        private:
+        SymbolTable *symbols;
+        const Symbol *name;
+        std::vector<Port> ports;
+
+        public:
+        Actor(SymbolTable *symbols, const Symbol *name) : symbols(symbols), name(name) {}
+
+        std::string get_name() const {
+            return name->get_name();
+        }
+
+        const std::vector<Port>& get_ports() const {
+            return ports;
+        }
+
+        void add_port(const std::string &name, const std::string &fifo_name, PortDirection direction, const std::vector<int> &rates) {
+            ports.push_back(Port(symbols->intern(name), symbols->intern(fifo_name), direction, rates));
+        }
+
+        // Number of phases, the same for every port (checked by SystemValidator)
+        int get_num_phases() const {
+            return ports.empty() ? 1 : ports[0].get_rates().size();
+        }
+    };
+
+    // Entities of one kind in file order, with an index from the id of a
+    // symbol to the position of the entity with that name
+    template <class T>
+    using EntityVector = std::vector<T*, ArenaAllocator<T*> >;
+
+    template <class T>
+    class EntityList {
+        EntityVector<T> entities;
+        std::vector<int, ArenaAllocator<int> > positions;   // -1 where no entity has the name
+
+        public:
+        explicit EntityList(Arena *arena) : entities(ArenaAllocator<T*>(arena)), positions(ArenaAllocator<int>(arena)) {}
+
+        // False if the name is taken
+        bool add(const Symbol *name, T *entity) {
+            if (name->id >= static_cast<int>(positions.size())) {
+                positions.resize(name->id + 1, -1);
+            } else if (positions[name->id] >= 0) {
+                return false;
+            }
+            positions[name->id] = entities.size();
+            entities.push_back(entity);
+            return true;
+        }
+
+        T *find(const Symbol *name) const {
+            if (!name || name->id >= static_cast<int>(positions.size()) || positions[name->id] < 0) {
+                return NULL;
+            }
+            return entities[positions[name->id]];
+        }
+
+        const EntityVector<T>& get() const {
+            return entities;
+        }
     };
 
+    // The create functions allocate an entity in the arena of the system, the
+    // add functions make it part of the system, unless its name is taken.
+    // Entities are freed together with the system. Each kind is kept in file
+    // order, which is the order SystemBuilder numbers them in.
     class System {
-        friend class ::SystemLoader;
         friend class ::SystemValidator;
-        std::unordered_map<std::string, Scheduler*> schedulers;
-        std::unordered_map<std::string, Task*> tasks;
-        std::unordered_map<std::string, Processor*> processors;
-        std::unordered_map<std::string, Mapping*> mappings;
-        std::unordered_map<std::string, Fifo*> fifos;
+        friend class ::SystemSnapshot;
+        Arena arena;            // Declared first, so it is destroyed last
+        SymbolTable symbols;
+        EntityList<Scheduler> schedulers;
+        EntityList<Task> tasks;
+        EntityList<Processor> processors;
+        EntityList<Mapping> mappings;
+        EntityList<Fifo> fifos;
+        EntityList<Actor> actors;
 
         public:
+        System() : symbols(&arena), schedulers(&arena), tasks(&arena), processors(&arena),
+                   mappings(&arena), fifos(&arena), actors(&arena) {}
+
+        Scheduler *createScheduler(const std::string &name, Algorithm algorithm, SchedulerType type, const std::string &mapping_name) {
+            return arena.create<Scheduler>(&symbols, symbols.intern(name), algorithm, type, symbols.intern(mapping_name));
+        }
+
+        Task *createTask(const std::string &name, int wcet, int read_delay, int write_delay, int start_time,
+                         int period, int deadline, int priority, TaskType type) {
+            return arena.create<Task>(symbols.intern(name), wcet, read_delay, write_delay, start_time, period, deadline, priority, type);
+        }
+
+        Processor *createProcessor(const std::string &name, const std::string &scheduler_name) {
+            return arena.create<Processor>(symbols.intern(name), symbols.intern(scheduler_name));
+        }
+
+        Mapping *createMapping(const std::string &name) {
+            return arena.create<Mapping>(&symbols, symbols.intern(name));
+        }
+
+        Fifo *createFifo(const std::string &name, int size, int read_latency = 1, int write_latency = 1, int bandwidth = 1) {
+            return arena.create<Fifo>(symbols.intern(name), size, read_latency, write_latency, bandwidth);
+        }
+
+        Actor *createActor(const std::string &name) {
+            return arena.create<Actor>(&symbols, symbols.intern(name));
+        }
+
         bool addScheduler(Scheduler *scheduler) {
-            if (!scheduler) return false;
-            auto ret = schedulers.insert(std::make_pair(scheduler->get_name(), scheduler));
-            return ret.second;
+            return scheduler && schedulers.add(scheduler->name, scheduler);
         }
 
         bool addTask(Task *task) {
-            if (!task) return false;
-            auto ret = tasks.insert(std::make_pair(task->get_name(), task));
-            return ret.second;
+            return task && tasks.add(task->name, task);
         }
 
         bool addProcessor(Processor *processor) {
-            if (!processor) return false;
-            auto ret = processors.insert(std::make_pair(processor->get_name(), processor));
-            return ret.second;
+            return processor && processors.add(processor->name, processor);
         }
 
         bool addMapping(Mapping *mapping) {
-            if (!mapping) return false;
-            auto ret = mappings.insert(std::make_pair(mapping->get_name(), mapping));
-            return ret.second;
+            return mapping && mappings.add(mapping->name, mapping);
         }
 
         bool addFifo(Fifo *fifo) {
-            if (!fifo) return false;
-            auto ret = fifos.insert(std::make_pair(fifo->get_name(), fifo));
-            return ret.second;
+            return fifo && fifos.add(fifo->name, fifo);
         }
 
-        const std::unordered_map<std::string, Processor*>& get_processors() const {
-            return processors;
+        bool addActor(Actor *actor) {
+            return actor && actors.add(actor->name, actor);
         }
 
-        const std::unordered_map<std::string, Scheduler*>& get_schedulers() const {
-            return schedulers;
+        const EntityVector<Scheduler>& get_schedulers() const {
+            return schedulers.get();
         }
 
-        const std::unordered_map<std::string, Task*>& get_tasks() const {
-            return tasks;
+        const EntityVector<Task>& get_tasks() const {
+            return tasks.get();
         }
 
-        const std::unordered_map<std::string, Mapping*>& get_mappings() const {
-            return mappings;
+        const EntityVector<Processor>& get_processors() const {
+            return processors.get();
         }
 
-        const Fifo* get_fifo(const std::string &fifo_name) const {
-            auto iter = fifos.find(fifo_name);
-            if (iter == fifos.end()) {
-                return NULL;
-            }
+        const EntityVector<Mapping>& get_mappings() const {
+            return mappings.get();
+        }
 
-            return iter->second;
+        const EntityVector<Fifo>& get_fifos() const {
+            return fifos.get();
         }
 
-        ~System() {
-            for (auto it : schedulers) {
-                delete it.second;
-            }
+        const EntityVector<Actor>& get_actors() const {
+            return actors.get();
+        }
 
-            for (auto it : tasks) {
-                delete it.second;
-            }
+        // Lookups by name return NULL if there is no such entity
+        const Scheduler* get_scheduler(const std::string &scheduler_name) const {
+            return schedulers.find(symbols.find(scheduler_name));
+        }
 
-            for (auto it : processors) {
-                delete it.second;
-            }
+        const Task* get_task(const std::string &task_name) const {
+            return tasks.find(symbols.find(task_name));
+        }
 
-            for (auto it : mappings) {
-                delete it.second;
-            }
+        const Processor* get_processor(const std::string &processor_name) const {
+            return processors.find(symbols.find(processor_name));
+        }
 
-            for (auto it : fifos) {
-                delete it.second;
-            }
+        const Mapping* get_mapping(const std::string &mapping_name) const {
+            return mappings.find(symbols.find(mapping_name));
+        }
+
+        const Fifo* get_fifo(const std::string &fifo_name) const {
+            return fifos.find(symbols.find(fifo_name));
+        }
+
+        // Memory used by the entities, their names and the indexes
+        size_t get_allocated() const {
+            return arena.get_allocated();
         }
     };
 }
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string>
 #include "systemloader.h"
+#include "xmlsupport.h"
 using namespace std;
 
 bool SystemLoader::getAttributeValue(xmlNode *node, const string &attribute_name, string &attribute_value) {
@@ -8,7 +9,7 @@ bool SystemLoader::getAttributeValue(xmlNode *node, const string &attribute_name
     xmlAttrPtr attribute = xmlHasProp(node, BAD_CAST attribute_name.c_str());
     if (!attribute) {
         if (required) {
-            cerr << "Missing attribute '" << attribute_name << "' for element '" << node->name << "' on line " << node->line << endl;
+            errors << "Missing attribute '" << attribute_name << "' for element '" << node->name << "' on line " << node->line << endl;
         }
         return false;
     }
@@ -27,7 +28,7 @@ bool SystemLoader::getAttributeValue(xmlNode *node, const string &attribute_name
     try {
         attribute_value = stoi(value);
     } catch (exception) {
-        cerr << "Invalid argument for " << attribute_name << " on line " << node->line << ": " << value << endl;
+        errors << "Invalid argument for " << attribute_name << " on line " << node->line << ": " << value << endl;
         return false;
     }
 
@@ -53,8 +54,10 @@ systemdata::Scheduler *SystemLoader::processScheduler(xmlNode *scheduler_node) {
         algorithm = systemdata::SCHED_STATIC;
     } else if (algorithm_name == "EDF") {
         algorithm = systemdata::SCHED_EDF;
+    } else if (algorithm_name == "FP") {
+        algorithm = systemdata::SCHED_FP;
     } else {
-        cerr << "Invalid algorithm: " << algorithm_name << " for scheduler " << scheduler_name << endl;
+        errors << "Invalid algorithm: " << algorithm_name << " for scheduler " << scheduler_name << endl;
         return NULL;
     }
 
@@ -65,11 +68,34 @@ systemdata::Scheduler *SystemLoader::processScheduler(xmlNode *scheduler_node) {
     } else if (type_name == "hybrid-semipartitioned") {
         type = systemdata::SCHEDTYPE_HYBRID;
     } else {
-        cerr << "Invalid scheduler type: " << type_name << " for scheduler " << scheduler_name << endl;
+        errors << "Invalid scheduler type: " << type_name << " for scheduler " << scheduler_name << endl;
         return NULL;
     }
 
-    return new systemdata::Scheduler(scheduler_name, algorithm, type, mapping_name);
+    scheduler = system->createScheduler(scheduler_name, algorithm, type, mapping_name);
+
+    // Optional explicit dispatch table
+    for (xmlNode *snode = scheduler_node->children; snode; snode = snode->next) {
+        if (snode->type != XML_ELEMENT_NODE) continue;
+
+        if (!xmlStrEqual(snode->name, BAD_CAST "slot")) {
+            errors << "Invalid element '" << snode->name << "' on line " << snode->line << endl;
+            return NULL;
+        }
+
+        string processor_name, task_name;
+        int start, length;
+        if (!getAttributeValue(snode, "processor", processor_name) ||
+            !getAttributeValue(snode, "task", task_name) ||
+            !getAttributeValue(snode, "start", start) ||
+            !getAttributeValue(snode, "length", length)) {
+            return NULL;
+        }
+
+        scheduler->add_slot(processor_name, task_name, start, length);
+    }
+
+    return scheduler;
 }
 
 systemdata::Task *SystemLoader::processTask(xmlNode *task_node) {
@@ -95,11 +121,11 @@ systemdata::Task *SystemLoader::processTask(xmlNode *task_node) {
     } else if (type_name == "migrating") {
         type = systemdata::TASKTYPE_MIGRATING;
     } else {
-        cerr << "Invalid task type: " << type_name << " for task " << task_name << endl;
+        errors << "Invalid task type: " << type_name << " for task " << task_name << endl;
         return NULL;
     }
 
-    return new systemdata::Task(task_name, wcet, read_delay, write_delay, start_time, period, deadline, priority, type);
+    return system->createTask(task_name, wcet, read_delay, write_delay, start_time, period, deadline, priority, type);
 }
 
 systemdata::Processor *SystemLoader::processProcessor(xmlNode *processor_node) {
@@ -109,84 +135,157 @@ systemdata::Processor *SystemLoader::processProcessor(xmlNode *processor_node) {
         return NULL;
     }
 
-    return new systemdata::Processor(processor_name, scheduler_name);
+    return system->createProcessor(processor_name, scheduler_name);
 }
 
 systemdata::Fifo *SystemLoader::processFifo(xmlNode *fifo_node) {
     string name;
     int size;
+    int read_latency = 1, write_latency = 1, bandwidth = 1;
     if (!getAttributeValue(fifo_node, "name", name) ||
         !getAttributeValue(fifo_node, "size", size)) {
         return NULL;
     }
 
-    return new systemdata::Fifo(name, size);
+    // Latencies and bandwidth are optional
+    if ((xmlHasProp(fifo_node, BAD_CAST "readLatency") && !getAttributeValue(fifo_node, "readLatency", read_latency)) ||
+        (xmlHasProp(fifo_node, BAD_CAST "writeLatency") && !getAttributeValue(fifo_node, "writeLatency", write_latency)) ||
+        (xmlHasProp(fifo_node, BAD_CAST "bandwidth") && !getAttributeValue(fifo_node, "bandwidth", bandwidth))) {
+        return NULL;
+    }
+
+    return system->createFifo(name, size, read_latency, write_latency, bandwidth);
 }
 
 systemdata::Mapping *SystemLoader::processMapping(xmlNode *mapping_node) {
-    systemdata::Mapping *mapping = new systemdata::Mapping();
     string name;
-
     if (!getAttributeValue(mapping_node, "name", name)) {
         return NULL;
     }
 
-    mapping->name = name;
+    systemdata::Mapping *mapping = system->createMapping(name);
 
     for (xmlNode *pnode = mapping_node->children; pnode; pnode = pnode->next) {
         if (pnode->type != XML_ELEMENT_NODE) continue;
 
         if (!xmlStrEqual(pnode->name, BAD_CAST "processor")) {
-            cerr << "Invalid element '" << pnode->name << "' on line " << pnode->line << endl;
-            delete mapping;
+            errors << "Invalid element '" << pnode->name << "' on line " << pnode->line << endl;
             return NULL;
         }
 
         string processor_name;
         if (!getAttributeValue(pnode, "name", processor_name)) {
-            delete mapping;
             return NULL;
         }
 
-        systemdata::Mapping::ProcessorEntry *pentry = new systemdata::Mapping::ProcessorEntry(processor_name);
+        systemdata::Mapping::ProcessorEntry *pentry = mapping->add_entry(processor_name);
 
         for (xmlNode *tnode = pnode->children; tnode; tnode = tnode->next) {
             if (tnode->type != XML_ELEMENT_NODE) continue;
 
             if (!xmlStrEqual(tnode->name, BAD_CAST "task")) {
-                cerr << "Invalid element '" << tnode->name << "' on line " << tnode->line << endl;
-                delete mapping;
+                errors << "Invalid element '" << tnode->name << "' on line " << tnode->line << endl;
                 return NULL;
             }
 
             string task_name;
             if (!getAttributeValue(tnode, "name", task_name)) {
-                delete mapping;
                 return NULL;
             }
 
-            systemdata::Mapping::TaskEntry *task_entry = new systemdata::Mapping::TaskEntry(task_name);
-            pentry->tasks.push_back(task_entry);
+            pentry->add_task(task_name);
         }
-
-        mapping->entries.push_back(pentry);
     }
 
     return mapping;
 }
 
+// Comma-separated list of rates, one per phase
+bool SystemLoader::parseRates(xmlNode *node, const string &value, vector<int> &rates) {
+    size_t begin = 0;
+    while (true) {
+        size_t end = value.find(',', begin);
+        string rate = value.substr(begin, end == string::npos ? string::npos : end - begin);
+        try {
+            rates.push_back(stoi(rate));
+        } catch (exception) {
+            errors << "Invalid argument for rates on line " << node->line << ": " << value << endl;
+            return false;
+        }
+        if (end == string::npos) break;
+        begin = end + 1;
+    }
+
+    return true;
+}
+
+systemdata::Actor *SystemLoader::processActor(xmlNode *actor_node) {
+    string name;
+    if (!getAttributeValue(actor_node, "name", name)) {
+        return NULL;
+    }
+
+    systemdata::Actor *actor = system->createActor(name);
+
+    for (xmlNode *pnode = actor_node->children; pnode; pnode = pnode->next) {
+        if (pnode->type != XML_ELEMENT_NODE) continue;
+
+        if (!xmlStrEqual(pnode->name, BAD_CAST "port")) {
+            errors << "Invalid element '" << pnode->name << "' on line " << pnode->line << endl;
+            return NULL;
+        }
+
+        string port_name, fifo_name, direction_name, rates_value;
+        systemdata::PortDirection direction;
+        vector<int> rates;
+        if (!getAttributeValue(pnode, "name", port_name) ||
+            !getAttributeValue(pnode, "fifo", fifo_name) ||
+            !getAttributeValue(pnode, "direction", direction_name) ||
+            !getAttributeValue(pnode, "rates", rates_value) ||
+            !parseRates(pnode, rates_value, rates)) {
+            return NULL;
+        }
+
+        if (direction_name == "in") {
+            direction = systemdata::PORT_IN;
+        } else if (direction_name == "out") {
+            direction = systemdata::PORT_OUT;
+        } else {
+            errors << "Invalid direction: " << direction_name << " for port " << port_name << " of actor " << name << endl;
+            return NULL;
+        }
+
+        actor->add_port(port_name, fifo_name, direction, rates);
+    }
+
+    return actor;
+}
+
 systemdata::System *SystemLoader::load(const string &filename) {
-    LIBXML_TEST_VERSION
+    init_libxml();
+    errors.str("");
+
+    // Errors of the parser go to this loader instead of libxml2's global handler
+    xmlParserCtxtPtr ctxt = xmlNewParserCtxt();
+    if (!ctxt) {
+        errors << "Out of memory" << endl;
+        return NULL;
+    }
 
-    xmlDocPtr doc;
-    doc = xmlReadFile(filename.c_str(), NULL, 0);
+    xmlDocPtr doc = xmlCtxtReadFile(ctxt, filename.c_str(), NULL, XML_PARSE_NOERROR | XML_PARSE_NOWARNING);
     if (!doc) {
-        cerr << "Couldn't open file: " << filename << endl;
+        XmlError error = xmlCtxtGetLastError(ctxt);
+        if (error && error->code != XML_ERR_OK) {
+            write_xml_error(errors, error);
+        }
+        errors << "Couldn't open file: " << filename << endl;
+        xmlFreeParserCtxt(ctxt);
         return NULL;
     }
+    xmlFreeParserCtxt(ctxt);
 
     xmlNode *root = xmlDocGetRootElement(doc);
-    systemdata::System *system = new systemdata::System();
+    system = new systemdata::System();
 
     for (xmlNode *node = root->children; node; node = node->next) {
         bool ret;
@@ -202,24 +301,24 @@ systemdata::System *SystemLoader::load(const string &filename) {
             ret = system->addFifo(processFifo(node));
         } else if (xmlStrEqual(node->name, BAD_CAST "mapping")) {
             ret = system->addMapping(processMapping(node));
+        } else if (xmlStrEqual(node->name, BAD_CAST "actor")) {
+            ret = system->addActor(processActor(node));
         } else {
-            cerr << "Unsupported element: '" << node->name << "'" << endl;
-            xmlFreeDoc(doc);
-            xmlCleanupParser();
-            delete system;
-            return NULL;
+            errors << "Unsupported element: '" << node->name << "'" << endl;
+            ret = false;
         }
 
         if (!ret) {
             xmlFreeDoc(doc);
-            xmlCleanupParser();
             delete system;
+            system = NULL;
             return NULL;
         }
     }
 
     xmlFreeDoc(doc);
-    xmlCleanupParser();
 
-    return system;
+    systemdata::System *ret = system;
+    system = NULL;
+    return ret;
 }
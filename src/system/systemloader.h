@@ -2,13 +2,19 @@
 #define SYSTEMLOADER_H
 
 #include <string>
+#include <sstream>
 #include <vector>
 #include <unordered_map>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include "systemdata.h"
 
+// An instance loads one file at a time, but instances can be used from
+// several threads at once
 class SystemLoader {
+    systemdata::System *system;         // While loading
+    std::ostringstream errors;
+
     bool getAttributeValue(xmlNode *node, const std::string &attribute_name, std::string &attribute_value);
     bool getAttributeValue(xmlNode *node, const std::string &attribute_name, int &attribute_value);
     systemdata::Task *processTask(xmlNode *task_node);
@@ -16,9 +22,17 @@ class SystemLoader {
     systemdata::Processor *processProcessor(xmlNode *processor_node);
     systemdata::Fifo *processFifo(xmlNode *fifo_node);
     systemdata::Mapping *processMapping(xmlNode *mapping_node);
+    systemdata::Actor *processActor(xmlNode *actor_node);
+    bool parseRates(xmlNode *node, const std::string &value, std::vector<int> &rates);
 
 public:
+    // NULL on errors, which are then described by get_errors()
     systemdata::System *load(const std::string &filename);
+
+    // Messages of the last load, one per line
+    std::string get_errors() const {
+        return errors.str();
+    }
 };
 
 #endif // SYSTEMLOADER_H
@@ -0,0 +1,616 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "systemsnapshot.h"
+#include "systemvalidator.h"
+using namespace std;
+
+static const unsigned int snapshot_magic = 0x53595353;      // "SSYS"
+static const unsigned int snapshot_version = 2;
+
+// Sections of the file, in this order. Entities are stored in file order, as
+// the System lists them, links between them are indexes into their sections
+// and -1 if unset.
+enum Section {
+    SECTION_SYMBOLS,
+    SECTION_SCHEDULERS,
+    SECTION_SLOTS,
+    SECTION_TASKS,
+    SECTION_PROCESSORS,
+    SECTION_MAPPINGS,
+    SECTION_ENTRIES,
+    SECTION_TASK_ENTRIES,
+    SECTION_FIFOS,
+    SECTION_ACTORS,
+    SECTION_PORTS,
+    SECTION_RATES,
+    SECTION_CHARS,
+    NUM_SECTIONS
+};
+
+struct SnapshotHeader {
+    unsigned int magic;
+    unsigned int version;
+    unsigned long long source_hash;
+    unsigned int offsets[NUM_SECTIONS];     // In bytes from the start of the file
+    unsigned int counts[NUM_SECTIONS];
+};
+
+struct SymbolRecord {
+    unsigned int offset;        // Into the characters
+    unsigned int length;
+};
+
+struct SchedulerRecord {
+    int name;
+    int algorithm;
+    int type;
+    int mapping_name;
+    int mapping;
+    int first_slot;
+    int num_slots;
+};
+
+struct SlotRecord {
+    int processor_name;
+    int task_name;
+    int start;
+    int length;
+};
+
+struct TaskRecord {
+    int name;
+    int wcet;
+    int read_delay;
+    int write_delay;
+    int start_time;
+    int period;
+    int deadline;
+    int priority;
+    int type;
+    int mapping;
+    int processor;
+};
+
+struct ProcessorRecord {
+    int name;
+    int scheduler_name;
+    int scheduler;
+};
+
+struct MappingRecord {
+    int name;
+    int scheduler;
+    int first_entry;
+    int num_entries;
+};
+
+struct EntryRecord {
+    int processor_name;
+    int processor;
+    int first_task;
+    int num_tasks;
+};
+
+struct TaskEntryRecord {
+    int task_name;
+    int task;
+};
+
+struct FifoRecord {
+    int name;
+    int size;
+    int read_latency;
+    int write_latency;
+    int bandwidth;
+};
+
+struct ActorRecord {
+    int name;
+    int first_port;
+    int num_ports;
+};
+
+struct PortRecord {
+    int name;
+    int fifo_name;
+    int direction;
+    int first_rate;
+    int num_rates;
+};
+
+static const size_t record_sizes[NUM_SECTIONS] = {
+    sizeof(SymbolRecord), sizeof(SchedulerRecord), sizeof(SlotRecord), sizeof(TaskRecord),
+    sizeof(ProcessorRecord), sizeof(MappingRecord), sizeof(EntryRecord), sizeof(TaskEntryRecord),
+    sizeof(FifoRecord), sizeof(ActorRecord), sizeof(PortRecord), sizeof(int), sizeof(char)
+};
+
+// Read-only mapping of a whole file
+class MappedFile {
+    void *data;
+    size_t size;
+
+public:
+    MappedFile() : data(NULL), size(0) {}
+
+    ~MappedFile() {
+        if (data) munmap(data, size);
+    }
+
+    bool open(const string &filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0;
+        if (ok && st.st_size > 0) {
+            size = st.st_size;
+            data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                data = NULL;
+                ok = false;
+            }
+        }
+        close(fd);
+        return ok;
+    }
+
+    const char *get_data() const {
+        return static_cast<const char*>(data);
+    }
+
+    size_t get_size() const {
+        return size;
+    }
+};
+
+bool SystemSnapshot::hash_file(const string &filename, unsigned long long &hash) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        cerr << "Couldn't open file: " << filename << endl;
+        return false;
+    }
+
+    hash = 14695981039346656037ULL;
+    const unsigned char *data = reinterpret_cast<const unsigned char*>(file.get_data());
+    for (size_t i = 0; i < file.get_size(); i++) {
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+    }
+    return true;
+}
+
+// Position of every entity of an index in its section
+template <class T>
+static void number(const systemdata::EntityVector<T> &entities, unordered_map<const T*, int> &numbers) {
+    for (unsigned int i = 0; i < entities.size(); i++) {
+        numbers.insert(make_pair(entities[i], static_cast<int>(i)));
+    }
+}
+
+template <class T>
+static int number_of(const unordered_map<const T*, int> &numbers, const T *entity) {
+    auto iter = numbers.find(entity);
+    return iter == numbers.end() ? -1 : iter->second;
+}
+
+bool SystemSnapshot::write(const systemdata::System *system, unsigned long long source_hash, const string &filename) {
+    unordered_map<const systemdata::Scheduler*, int> scheduler_numbers;
+    unordered_map<const systemdata::Task*, int> task_numbers;
+    unordered_map<const systemdata::Processor*, int> processor_numbers;
+    unordered_map<const systemdata::Mapping*, int> mapping_numbers;
+    unordered_map<const systemdata::Fifo*, int> fifo_numbers;
+    number(system->get_schedulers(), scheduler_numbers);
+    number(system->get_tasks(), task_numbers);
+    number(system->get_processors(), processor_numbers);
+    number(system->get_mappings(), mapping_numbers);
+    number(system->get_fifos(), fifo_numbers);
+
+    vector<SymbolRecord> symbol_records;
+    string chars;
+    for (int id = 0; id < system->symbols.size(); id++) {
+        const systemdata::Symbol *symbol = system->symbols.get(id);
+        SymbolRecord r = { static_cast<unsigned int>(chars.size()), symbol->length };
+        symbol_records.push_back(r);
+        chars.append(symbol->get_chars(), symbol->length);
+    }
+
+    vector<SchedulerRecord> scheduler_records;
+    vector<SlotRecord> slot_records;
+    for (auto s : system->get_schedulers()) {
+        SchedulerRecord r = { s->name->id, s->algorithm, s->type, s->mapping_name->id, number_of(mapping_numbers, s->mapping),
+                              static_cast<int>(slot_records.size()), static_cast<int>(s->slots.size()) };
+        scheduler_records.push_back(r);
+        for (auto &slot : s->slots) {
+            SlotRecord sr = { slot.processor_name->id, slot.task_name->id, slot.start, slot.length };
+            slot_records.push_back(sr);
+        }
+    }
+
+    vector<TaskRecord> task_records;
+    for (auto t : system->get_tasks()) {
+        TaskRecord r = { t->name->id, t->wcet, t->read_delay, t->write_delay, t->start_time, t->period, t->deadline,
+                         t->priority, t->type, number_of(mapping_numbers, t->mapping), number_of(processor_numbers, t->processor) };
+        task_records.push_back(r);
+    }
+
+    vector<ProcessorRecord> processor_records;
+    for (auto p : system->get_processors()) {
+        ProcessorRecord r = { p->name->id, p->scheduler_name->id, number_of(scheduler_numbers, p->scheduler) };
+        processor_records.push_back(r);
+    }
+
+    vector<MappingRecord> mapping_records;
+    vector<EntryRecord> entry_records;
+    vector<TaskEntryRecord> task_entry_records;
+    for (auto m : system->get_mappings()) {
+        MappingRecord r = { m->name->id, number_of(scheduler_numbers, m->scheduler),
+                            static_cast<int>(entry_records.size()), static_cast<int>(m->entries.size()) };
+        mapping_records.push_back(r);
+        for (auto &entry : m->entries) {
+            EntryRecord er = { entry.processor_name->id, number_of(processor_numbers, entry.processor),
+                               static_cast<int>(task_entry_records.size()), static_cast<int>(entry.tasks.size()) };
+            entry_records.push_back(er);
+            for (auto &t : entry.tasks) {
+                TaskEntryRecord tr = { t.task_name->id, number_of(task_numbers, t.task) };
+                task_entry_records.push_back(tr);
+            }
+        }
+    }
+
+    vector<FifoRecord> fifo_records;
+    for (auto f : system->get_fifos()) {
+        FifoRecord r = { f->name->id, f->size, f->read_latency, f->write_latency, f->bandwidth };
+        fifo_records.push_back(r);
+    }
+
+    vector<ActorRecord> actor_records;
+    vector<PortRecord> port_records;
+    vector<int> rates;
+    for (auto a : system->get_actors()) {
+        ActorRecord r = { a->name->id, static_cast<int>(port_records.size()), static_cast<int>(a->ports.size()) };
+        actor_records.push_back(r);
+        for (auto &port : a->ports) {
+            PortRecord pr = { port.name->id, port.fifo_name->id, port.direction,
+                              static_cast<int>(rates.size()), static_cast<int>(port.rates.size()) };
+            port_records.push_back(pr);
+            rates.insert(rates.end(), port.rates.begin(), port.rates.end());
+        }
+    }
+
+    const void *data[NUM_SECTIONS] = {
+        symbol_records.data(), scheduler_records.data(), slot_records.data(), task_records.data(),
+        processor_records.data(), mapping_records.data(), entry_records.data(), task_entry_records.data(),
+        fifo_records.data(), actor_records.data(), port_records.data(), rates.data(), chars.data()
+    };
+    size_t counts[NUM_SECTIONS] = {
+        symbol_records.size(), scheduler_records.size(), slot_records.size(), task_records.size(),
+        processor_records.size(), mapping_records.size(), entry_records.size(), task_entry_records.size(),
+        fifo_records.size(), actor_records.size(), port_records.size(), rates.size(), chars.size()
+    };
+
+    SnapshotHeader header = { snapshot_magic, snapshot_version, source_hash, {}, {} };
+    size_t offset = sizeof(header);
+    for (int i = 0; i < NUM_SECTIONS; i++) {
+        header.offsets[i] = offset;
+        header.counts[i] = counts[i];
+        offset += counts[i] * record_sizes[i];
+    }
+    if (offset > 0xffffffffu) {
+        cerr << "Error: system too large for a snapshot" << endl;
+        return false;
+    }
+
+    // Written next to the target and renamed, so concurrent runs never map a partial file
+    string tmp_filename = filename + ".tmp" + to_string(getpid());
+    ofstream stream(tmp_filename, ios::binary);
+    if (!stream) {
+        cerr << "Error: cannot write snapshot '" << filename << "'" << endl;
+        return false;
+    }
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int i = 0; i < NUM_SECTIONS; i++) {
+        stream.write(static_cast<const char*>(data[i]), counts[i] * record_sizes[i]);
+    }
+    stream.close();
+
+    if (!stream || rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        cerr << "Error: cannot write snapshot '" << filename << "'" << endl;
+        remove(tmp_filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Creates the entities of a snapshot in a new system. Every index and enum
+// read from the file is range checked, so a damaged file cannot make the
+// reader go out of bounds. The values of the entities are checked by
+// SystemSnapshot::load afterwards.
+class SystemSnapshot::Reader {
+    const char *data;
+    const SnapshotHeader *header;
+    systemdata::System *system;
+    vector<const systemdata::Symbol*> symbols;
+    bool ok;
+
+    template <class T>
+    const T *section(Section s) const {
+        return reinterpret_cast<const T*>(data + header->offsets[s]);
+    }
+
+    // Index into a section, or -1 where optional is allowed
+    int check(int index, Section s, bool optional = false) {
+        if (index < 0 ? !(optional && index == -1) : index >= static_cast<int>(header->counts[s])) {
+            ok = false;
+            return optional ? -1 : 0;
+        }
+        return index;
+    }
+
+    // Range of records in a section
+    void check(int first, int count, Section s) {
+        if (first < 0 || count < 0 || first > static_cast<int>(header->counts[s]) - count) {
+            ok = false;
+        }
+    }
+
+    // Constant of an enum that runs from 0 to last
+    int check_enum(int value, int last) {
+        if (value < 0 || value > last) {
+            ok = false;
+            return 0;
+        }
+        return value;
+    }
+
+    // NULL once the file is found to be damaged
+    const systemdata::Symbol *symbol(int id) {
+        int i = check(id, SECTION_SYMBOLS);
+        return ok ? symbols[i] : NULL;
+    }
+
+    template <class T>
+    static T *entity(const vector<T*> &entities, int index) {
+        return index < 0 || index >= static_cast<int>(entities.size()) ? NULL : entities[index];
+    }
+
+    // The links have to be the ones SystemValidator resolves from the names,
+    // in the order it visits the entities, or the builder would register
+    // tasks and processors with the wrong schedulers
+    static bool links_match(const vector<systemdata::Scheduler*> &schedulers, const vector<systemdata::Task*> &tasks,
+                            const vector<systemdata::Processor*> &processors, const vector<systemdata::Mapping*> &mappings) {
+        unordered_map<const systemdata::Mapping*, const systemdata::Scheduler*> mapping_schedulers;
+        for (auto s : schedulers) {
+            if (s->mapping->name != s->mapping_name) {
+                return false;
+            }
+            mapping_schedulers.insert(make_pair(s->mapping, s));
+        }
+
+        for (auto p : processors) {
+            if (p->scheduler->name != p->scheduler_name) {
+                return false;
+            }
+        }
+
+        unordered_map<const systemdata::Task*, pair<const systemdata::Mapping*, const systemdata::Processor*> > task_links;
+        for (auto m : mappings) {
+            auto s = mapping_schedulers.find(m);
+            if (m->scheduler != (s == mapping_schedulers.end() ? NULL : s->second)) {
+                return false;
+            }
+            for (auto &entry : m->entries) {
+                if (entry.processor->name != entry.processor_name) {
+                    return false;
+                }
+                for (auto &t : entry.tasks) {
+                    if (t.task->name != t.task_name) {
+                        return false;
+                    }
+                    auto &links = task_links[t.task];
+                    if (links.first != m) {
+                        links = make_pair(m, entry.processor);
+                    }
+                }
+            }
+        }
+
+        for (auto t : tasks) {
+            auto links = task_links.find(t);
+            if (links == task_links.end() ? t->mapping || t->processor :
+                                            t->mapping != links->second.first || t->processor != links->second.second) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    Reader(const char *data, systemdata::System *system) :
+        data(data), header(reinterpret_cast<const SnapshotHeader*>(data)), system(system), ok(true) {}
+
+    bool read() {
+        const SymbolRecord *symbol_records = section<SymbolRecord>(SECTION_SYMBOLS);
+        const char *chars = section<char>(SECTION_CHARS);
+        for (unsigned int i = 0; i < header->counts[SECTION_SYMBOLS]; i++) {
+            const SymbolRecord &r = symbol_records[i];
+            if (r.offset > header->counts[SECTION_CHARS] || r.length > header->counts[SECTION_CHARS] - r.offset) {
+                return false;
+            }
+            const systemdata::Symbol *s = system->symbols.intern(string(chars + r.offset, r.length));
+            if (s->id != static_cast<int>(i)) {
+                return false;
+            }
+            symbols.push_back(s);
+        }
+
+        // Entities first, so links can point forward. Adding them in file
+        // order rebuilds the lookups by name.
+        vector<systemdata::Scheduler*> schedulers;
+        const SchedulerRecord *scheduler_records = section<SchedulerRecord>(SECTION_SCHEDULERS);
+        const SlotRecord *slot_records = section<SlotRecord>(SECTION_SLOTS);
+        for (unsigned int i = 0; i < header->counts[SECTION_SCHEDULERS]; i++) {
+            const SchedulerRecord &r = scheduler_records[i];
+            systemdata::Scheduler *s = system->arena.create<systemdata::Scheduler>(&system->symbols, symbol(r.name),
+                static_cast<systemdata::Algorithm>(check_enum(r.algorithm, systemdata::SCHED_FP)),
+                static_cast<systemdata::SchedulerType>(check_enum(r.type, systemdata::SCHEDTYPE_HYBRID)), symbol(r.mapping_name));
+            check(r.first_slot, r.num_slots, SECTION_SLOTS);
+            for (int j = 0; ok && j < r.num_slots; j++) {
+                const SlotRecord &slot = slot_records[r.first_slot + j];
+                s->slots.push_back(systemdata::Scheduler::Slot(symbol(slot.processor_name), symbol(slot.task_name), slot.start, slot.length));
+            }
+            if (!ok || !system->addScheduler(s)) {
+                return false;
+            }
+            schedulers.push_back(s);
+        }
+
+        vector<systemdata::Task*> tasks;
+        const TaskRecord *task_records = section<TaskRecord>(SECTION_TASKS);
+        for (unsigned int i = 0; i < header->counts[SECTION_TASKS]; i++) {
+            const TaskRecord &r = task_records[i];
+            systemdata::Task *t = system->arena.create<systemdata::Task>(symbol(r.name), r.wcet, r.read_delay, r.write_delay, r.start_time,
+                                                                         r.period, r.deadline, r.priority,
+                                                                         static_cast<systemdata::TaskType>(check_enum(r.type, systemdata::TASKTYPE_MIGRATING)));
+            if (!ok || !system->addTask(t)) {
+                return false;
+            }
+            tasks.push_back(t);
+        }
+
+        vector<systemdata::Processor*> processors;
+        const ProcessorRecord *processor_records = section<ProcessorRecord>(SECTION_PROCESSORS);
+        for (unsigned int i = 0; i < header->counts[SECTION_PROCESSORS]; i++) {
+            const ProcessorRecord &r = processor_records[i];
+            systemdata::Processor *p = system->arena.create<systemdata::Processor>(symbol(r.name), symbol(r.scheduler_name));
+            if (!ok || !system->addProcessor(p)) {
+                return false;
+            }
+            processors.push_back(p);
+        }
+
+        vector<systemdata::Mapping*> mappings;
+        const MappingRecord *mapping_records = section<MappingRecord>(SECTION_MAPPINGS);
+        for (unsigned int i = 0; i < header->counts[SECTION_MAPPINGS]; i++) {
+            systemdata::Mapping *m = system->arena.create<systemdata::Mapping>(&system->symbols, symbol(mapping_records[i].name));
+            if (!ok || !system->addMapping(m)) {
+                return false;
+            }
+            mappings.push_back(m);
+        }
+
+        vector<systemdata::Fifo*> fifos;
+        const FifoRecord *fifo_records = section<FifoRecord>(SECTION_FIFOS);
+        for (unsigned int i = 0; i < header->counts[SECTION_FIFOS]; i++) {
+            const FifoRecord &r = fifo_records[i];
+            systemdata::Fifo *f = system->arena.create<systemdata::Fifo>(symbol(r.name), r.size, r.read_latency, r.write_latency, r.bandwidth);
+            if (!ok || !system->addFifo(f)) {
+                return false;
+            }
+            fifos.push_back(f);
+        }
+
+        if (!ok) {
+            return false;
+        }
+
+        // Links resolved by SystemValidator when the snapshot was written. Only
+        // unused mappings and unmapped tasks may lack one.
+        for (unsigned int i = 0; i < schedulers.size(); i++) {
+            schedulers[i]->mapping = entity(mappings, check(scheduler_records[i].mapping, SECTION_MAPPINGS));
+        }
+
+        for (unsigned int i = 0; i < tasks.size(); i++) {
+            tasks[i]->mapping = entity(mappings, check(task_records[i].mapping, SECTION_MAPPINGS, true));
+            tasks[i]->processor = entity(processors, check(task_records[i].processor, SECTION_PROCESSORS, true));
+        }
+
+        for (unsigned int i = 0; i < processors.size(); i++) {
+            processors[i]->scheduler = entity(schedulers, check(processor_records[i].scheduler, SECTION_SCHEDULERS));
+        }
+
+        const EntryRecord *entry_records = section<EntryRecord>(SECTION_ENTRIES);
+        const TaskEntryRecord *task_entry_records = section<TaskEntryRecord>(SECTION_TASK_ENTRIES);
+        for (unsigned int i = 0; ok && i < mappings.size(); i++) {
+            const MappingRecord &r = mapping_records[i];
+            mappings[i]->scheduler = entity(schedulers, check(r.scheduler, SECTION_SCHEDULERS, true));
+            check(r.first_entry, r.num_entries, SECTION_ENTRIES);
+            for (int j = 0; ok && j < r.num_entries; j++) {
+                const EntryRecord &er = entry_records[r.first_entry + j];
+                mappings[i]->entries.push_back(systemdata::Mapping::ProcessorEntry(&system->symbols, symbol(er.processor_name)));
+                systemdata::Mapping::ProcessorEntry &entry = mappings[i]->entries.back();
+                entry.processor = entity(processors, check(er.processor, SECTION_PROCESSORS));
+
+                check(er.first_task, er.num_tasks, SECTION_TASK_ENTRIES);
+                for (int k = 0; ok && k < er.num_tasks; k++) {
+                    const TaskEntryRecord &tr = task_entry_records[er.first_task + k];
+                    entry.tasks.push_back(systemdata::Mapping::TaskEntry(symbol(tr.task_name)));
+                    entry.tasks.back().task = entity(tasks, check(tr.task, SECTION_TASKS));
+                }
+            }
+        }
+
+        const ActorRecord *actor_records = section<ActorRecord>(SECTION_ACTORS);
+        const PortRecord *port_records = section<PortRecord>(SECTION_PORTS);
+        const int *rates = section<int>(SECTION_RATES);
+        for (unsigned int i = 0; ok && i < header->counts[SECTION_ACTORS]; i++) {
+            const ActorRecord &r = actor_records[i];
+            systemdata::Actor *actor = system->arena.create<systemdata::Actor>(&system->symbols, symbol(r.name));
+            check(r.first_port, r.num_ports, SECTION_PORTS);
+            for (int j = 0; ok && j < r.num_ports; j++) {
+                const PortRecord &pr = port_records[r.first_port + j];
+                check(pr.first_rate, pr.num_rates, SECTION_RATES);
+                if (!ok) break;
+                actor->ports.push_back(systemdata::Actor::Port(symbol(pr.name), symbol(pr.fifo_name), static_cast<systemdata::PortDirection>(check_enum(pr.direction, systemdata::PORT_OUT)),
+                                                               vector<int>(rates + pr.first_rate, rates + pr.first_rate + pr.num_rates)));
+            }
+            if (!ok || !system->addActor(actor)) {
+                return false;
+            }
+        }
+
+        return ok && links_match(schedulers, tasks, processors, mappings);
+    }
+};
+
+systemdata::System *SystemSnapshot::load(const string &filename, unsigned long long source_hash) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        return NULL;
+    }
+
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader*>(file.get_data());
+    if (file.get_size() < sizeof(SnapshotHeader) || header->magic != snapshot_magic) {
+        cerr << "Warning: '" << filename << "' is not a system snapshot" << endl;
+        return NULL;
+    }
+    if (header->version != snapshot_version || header->source_hash != source_hash) {
+        return NULL;
+    }
+
+    for (int i = 0; i < NUM_SECTIONS; i++) {
+        if (header->offsets[i] % sizeof(int) != 0 || header->offsets[i] > file.get_size() ||
+            header->counts[i] > (file.get_size() - header->offsets[i]) / record_sizes[i]) {
+            cerr << "Warning: snapshot '" << filename << "' is truncated" << endl;
+            return NULL;
+        }
+    }
+
+    systemdata::System *system = new systemdata::System();
+    Reader reader(file.get_data(), system);
+    if (!reader.read() || !SystemValidator(system).validateValues()) {
+        cerr << "Warning: snapshot '" << filename << "' is damaged or was written by an incompatible build" << endl;
+        delete system;
+        return NULL;
+    }
+    return system;
+}
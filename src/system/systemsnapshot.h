@@ -0,0 +1,28 @@
+#ifndef SYSTEMSNAPSHOT_H
+#define SYSTEMSNAPSHOT_H
+
+#include <string>
+#include "systemdata.h"
+
+// Binary snapshot of a validated system, so runs of the same system can skip
+// parsing the XML and validating it. All references in the file are indexes
+// (names are symbol ids), so it can be mapped anywhere and its records are
+// read in place. A snapshot carries the content hash of the XML it was made
+// from and is only loaded for that same source.
+class SystemSnapshot {
+    class Reader;
+
+public:
+    // FNV-1a hash of the contents of a file
+    static bool hash_file(const std::string &filename, unsigned long long &hash);
+
+    // The system has to be validated, so all its links are resolved
+    static bool write(const systemdata::System *system, unsigned long long source_hash, const std::string &filename);
+
+    // NULL if there is no snapshot, or it was made from another source or by
+    // another version; damaged snapshots, including ones whose values do not
+    // pass validation, are reported on cerr
+    static systemdata::System *load(const std::string &filename, unsigned long long source_hash);
+};
+
+#endif // SYSTEMSNAPSHOT_H
@@ -0,0 +1,69 @@
+#include <cstring>
+#include "systemtables.h"
+using namespace std;
+
+namespace systemtables {
+    systemdata::System *build_system(const Tables &t) {
+        systemdata::System *system = new systemdata::System();
+
+        for (int i = 0; i < t.num_schedulers; i++) {
+            const SchedulerRow &r = t.schedulers[i];
+            systemdata::Scheduler *scheduler = system->createScheduler(r.name, r.algorithm, r.type, r.mapping);
+            for (int j = 0; j < t.num_slots; j++) {
+                const SlotRow &slot = t.slots[j];
+                if (strcmp(slot.scheduler, r.name) == 0) {
+                    scheduler->add_slot(slot.processor, slot.task, slot.start, slot.length);
+                }
+            }
+            system->addScheduler(scheduler);
+        }
+
+        for (int i = 0; i < t.num_tasks; i++) {
+            const TaskRow &r = t.tasks[i];
+            system->addTask(system->createTask(r.name, r.wcet, r.read_delay, r.write_delay, r.start_time,
+                                                 r.period, r.deadline, r.priority, r.type));
+        }
+
+        for (int i = 0; i < t.num_processors; i++) {
+            system->addProcessor(system->createProcessor(t.processors[i].name, t.processors[i].scheduler));
+        }
+
+        // Consecutive rows of the same mapping and processor form one entry
+        systemdata::Mapping *mapping = NULL;
+        systemdata::Mapping::ProcessorEntry *entry = NULL;
+        for (int i = 0; i < t.num_mappings; i++) {
+            const MappingRow &r = t.mappings[i];
+            if (!mapping || mapping->get_name() != r.mapping) {
+                mapping = system->createMapping(r.mapping);
+                entry = NULL;
+                system->addMapping(mapping);
+            }
+            if (!r.processor) continue;
+            if (!entry || t.mappings[i - 1].entry != r.entry) {
+                entry = mapping->add_entry(r.processor);
+            }
+            if (r.task) {
+                entry->add_task(r.task);
+            }
+        }
+
+        for (int i = 0; i < t.num_fifos; i++) {
+            const FifoRow &r = t.fifos[i];
+            system->addFifo(system->createFifo(r.name, r.size, r.read_latency, r.write_latency, r.bandwidth));
+        }
+
+        systemdata::Actor *actor = NULL;
+        for (int i = 0; i < t.num_ports; i++) {
+            const PortRow &r = t.ports[i];
+            if (!actor || actor->get_name() != r.actor) {
+                actor = system->createActor(r.actor);
+                system->addActor(actor);
+            }
+            if (r.name) {
+                actor->add_port(r.name, r.fifo, r.direction, vector<int>(r.rates, r.rates + r.num_phases));
+            }
+        }
+
+        return system;
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef SYSTEMTABLES_H
+#define SYSTEMTABLES_H
+
+#include "systemdata.h"
+
+// Flat description of a system, as emitted by sysgen in constexpr arrays.
+// Rows are in the order of the system file, so building a System from them
+// yields the same task and processor numbering as loading the file.
+namespace systemtables {
+    struct SchedulerRow {
+        const char *name;
+        systemdata::Algorithm algorithm;
+        systemdata::SchedulerType type;
+        const char *mapping;
+    };
+
+    struct SlotRow {
+        const char *scheduler;
+        const char *processor;
+        const char *task;
+        int start;
+        int length;
+    };
+
+    struct TaskRow {
+        const char *name;
+        int wcet;
+        int read_delay;
+        int write_delay;
+        int start_time;
+        int period;
+        int deadline;
+        int priority;
+        systemdata::TaskType type;
+    };
+
+    struct ProcessorRow {
+        const char *name;
+        const char *scheduler;
+    };
+
+    // One row per task of a processor entry (entry counts the entries of the
+    // mapping); processor or task is NULL for an empty mapping or processor entry
+    struct MappingRow {
+        const char *mapping;
+        int entry;
+        const char *processor;
+        const char *task;
+    };
+
+    struct FifoRow {
+        const char *name;
+        int size;
+        int read_latency;
+        int write_latency;
+        int bandwidth;
+    };
+
+    // Actors without ports have a row with a NULL port name
+    struct PortRow {
+        const char *actor;
+        const char *name;
+        const char *fifo;
+        systemdata::PortDirection direction;
+        const int *rates;
+        int num_phases;
+    };
+
+    struct Tables {
+        const SchedulerRow *schedulers; int num_schedulers;
+        const SlotRow *slots; int num_slots;
+        const TaskRow *tasks; int num_tasks;
+        const ProcessorRow *processors; int num_processors;
+        const MappingRow *mappings; int num_mappings;
+        const FifoRow *fifos; int num_fifos;
+        const PortRow *ports; int num_ports;
+    };
+
+    // Builds the System; it still has to be validated to resolve the references
+    systemdata::System *build_system(const Tables &tables);
+}
+
+#endif // SYSTEMTABLES_H
@@ -1,92 +1,157 @@
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include "systemvalidator.h"
+#include "../fsl_pipeline.h"
 using namespace std;
 
-SystemValidator::SystemValidator(systemdata::System *system) {
-    // Write errors to cerr
-    errors = &cerr;
+SystemValidator::SystemValidator(systemdata::System *system, ostream &errors) {
+    this->errors = &errors;
     this->system = system;
 }
 
 bool SystemValidator::validateSystem(systemdata::System *system) {
     // TODO: Check the system as a whole (e.g. how many schedulers, mixing schedulers of different types, ...)
+    bool ret = true;
 
-    return true;
+    // Every fifo of the actor network connects exactly one writer to one reader
+    unordered_map<const systemdata::Symbol*, const systemdata::Symbol*, systemdata::SymbolHash> readers, writers;
+    for (auto actor : system->actors.get()) {
+        for (auto &port : actor->ports) {
+            auto &ends = port.direction == systemdata::PORT_IN ? readers : writers;
+            auto end = ends.insert(make_pair(port.fifo_name, actor->name));
+            if (!end.second) {
+                *errors << "Fifo '" << *port.fifo_name << "' is " << (port.direction == systemdata::PORT_IN ? "read" : "written")
+                        << " by both actor '" << *end.first->second << "' and actor '" << *actor->name << "'" << endl;
+                ret = false;
+            }
+        }
+    }
+
+    for (auto reader : readers) {
+        if (writers.find(reader.first) == writers.end()) {
+            *errors << "Fifo '" << *reader.first << "' read by actor '" << *reader.second << "' is not written by any actor" << endl;
+            ret = false;
+        }
+    }
+
+    for (auto writer : writers) {
+        if (readers.find(writer.first) == readers.end()) {
+            *errors << "Fifo '" << *writer.first << "' written by actor '" << *writer.second << "' is not read by any actor" << endl;
+            ret = false;
+        }
+    }
+
+    return ret;
 }
 
 bool SystemValidator::validateScheduler(systemdata::Scheduler *scheduler) {
     if (!validateName(scheduler->name)) {
-        *errors << "Invalid scheduler name '" << scheduler->name << "'" << endl;
+        *errors << "Invalid scheduler name '" << *scheduler->name << "'" << endl;
         return false;
     }
 
     // Find mapping
-    auto iter = system->mappings.find(scheduler->mapping_name);
-    if (iter == system->mappings.end()) {
-        *errors << "Mapping '" << scheduler->mapping_name << "' for scheduler '" << scheduler->name << "' not found" << endl;
+    systemdata::Mapping *mapping = system->mappings.find(scheduler->mapping_name);
+    if (!mapping) {
+        *errors << "Mapping '" << *scheduler->mapping_name << "' for scheduler '" << *scheduler->name << "' not found" << endl;
         return false;
     }
 
-    scheduler->mapping = iter->second;
+    scheduler->mapping = mapping;
+    if (!mapping->scheduler) {
+        mapping->scheduler = scheduler;
+    }
 
-    return true;
+    bool ret = true;
+    if (!scheduler->slots.empty() && scheduler->algorithm != systemdata::SCHED_STATIC) {
+        *errors << "Dispatch table for scheduler '" << *scheduler->name << "' is only supported by static schedulers" << endl;
+        ret = false;
+    }
+
+    for (auto &slot : scheduler->slots) {
+        systemdata::Processor *proc = system->processors.find(slot.processor_name);
+        if (!proc) {
+            *errors << "Processor '" << *slot.processor_name << "' for slot of scheduler '" << *scheduler->name << "' not found" << endl;
+            ret = false;
+        } else if (proc->scheduler_name != scheduler->name) {
+            *errors << "Processor '" << *slot.processor_name << "' for slot of scheduler '" << *scheduler->name << "' belongs to another scheduler" << endl;
+            ret = false;
+        }
+
+        if (!system->tasks.find(slot.task_name)) {
+            *errors << "Task '" << *slot.task_name << "' for slot of scheduler '" << *scheduler->name << "' not found" << endl;
+            ret = false;
+        }
+
+        if (slot.start < 0) {
+            *errors << "start for slot of task '" << *slot.task_name << "' should be >= 0" << endl;
+            ret = false;
+        }
+
+        if (slot.length <= 0) {
+            *errors << "length for slot of task '" << *slot.task_name << "' should be > 0" << endl;
+            ret = false;
+        }
+    }
+
+    return ret;
 }
 
 bool SystemValidator::validateTask(systemdata::Task *task) {
     bool ret = true;
     if (!validateName(task->name)) {
-        *errors << "Invalid task name '" << task->name << "'" << endl;
+        *errors << "Invalid task name '" << *task->name << "'" << endl;
         ret = false;
     }
 
     if (task->wcet <= 0) {
-        *errors << "wcet for task '" << task->name << "' should be > 0" << endl;
+        *errors << "wcet for task '" << *task->name << "' should be > 0" << endl;
         ret = false;
     }
 
     if (task->read_delay < 0) {
-        *errors << "Read delay for task '" << task->name << "' should be >= 0" << endl;
+        *errors << "Read delay for task '" << *task->name << "' should be >= 0" << endl;
         ret = false;
     }
 
     if (task->write_delay < 0) {
-        *errors << "Write delay for task '" << task->name << "' should be >= 0" << endl;
+        *errors << "Write delay for task '" << *task->name << "' should be >= 0" << endl;
         ret = false;
     }
 
     if (task->start_time < 0) {
-        *errors << "start time for task '" << task->name << "' should be >= 0" << endl;
+        *errors << "start time for task '" << *task->name << "' should be >= 0" << endl;
         ret = false;
     }
 
     if (task->period <= 0) {
-        *errors << "period for task '" << task->name << "' should be > 0" << endl;
+        *errors << "period for task '" << *task->name << "' should be > 0" << endl;
         ret = false;
     }
 
     if (task->deadline <= 0) {
-        *errors << "deadline for task '" << task->name << "' should be > 0" << endl;
+        *errors << "deadline for task '" << *task->name << "' should be > 0" << endl;
         ret = false;
     }
 
     if (task->priority <= 0) {
-        *errors << "priority for task '" << task->name << "' should be > 0" << endl;
+        *errors << "priority for task '" << *task->name << "' should be > 0" << endl;
         ret = false;
     }
 
     if (task->wcet > task->period) {
-        *errors << "wcet for task '" << task->name << "' should be <= period" << endl;
+        *errors << "wcet for task '" << *task->name << "' should be <= period" << endl;
         ret = false;
     }
 
     if (task->deadline > task->period) {
-        *errors << "deadline for task '" << task->name << "' should be <= period" << endl;
+        *errors << "deadline for task '" << *task->name << "' should be <= period" << endl;
         ret = false;
     }
 
     if (task->wcet > task->deadline) {
-        *errors << "wcet for task '" << task->name << "' should be <= deadline" << endl;
+        *errors << "wcet for task '" << *task->name << "' should be <= deadline" << endl;
         ret = false;
     }
 
@@ -95,47 +160,60 @@ bool SystemValidator::validateTask(systemdata::Task *task) {
 
 bool SystemValidator::validateProcessor(systemdata::Processor *processor) {
     if (!validateName(processor->name)) {
-        *errors << "Invalid processor name '" << processor->name << "'" << endl;
+        *errors << "Invalid processor name '" << *processor->name << "'" << endl;
         return false;
     }
 
     // Associate scheduler with processor
-    auto iter = system->schedulers.find(processor->scheduler_name);
-    if (iter == system->schedulers.end()) {
-        *errors << "Scheduler '" << processor->scheduler_name << "' for processor '" << processor->name << "' not found" << endl;
+    processor->scheduler = system->schedulers.find(processor->scheduler_name);
+    if (!processor->scheduler) {
+        *errors << "Scheduler '" << *processor->scheduler_name << "' for processor '" << *processor->name << "' not found" << endl;
         return false;
     }
 
-    processor->scheduler = iter->second;
-
     return true;
 }
 
 bool SystemValidator::validateMapping(systemdata::Mapping *mapping) {
     bool ret = true;
 
+    // A hybrid scheduler only splits migrating tasks over processors
+    bool hybrid = mapping->scheduler && mapping->scheduler->type == systemdata::SCHEDTYPE_HYBRID;
+    unordered_map<const systemdata::Task*, const systemdata::Symbol*> fixed_processor;
+
     if (!validateName(mapping->name)) {
-        *errors << "Invalid mapping name '" << mapping->name << "'" << endl;
+        *errors << "Invalid mapping name '" << *mapping->name << "'" << endl;
         ret = false;
     }
 
-    for (auto p : mapping->entries) {
+    for (auto &p : mapping->entries) {
         // Find processor
-        auto proc = system->processors.find(p->processor_name);
-        if (proc == system->processors.end()) {
-            *errors << "Processor '" << p->processor_name << "' for mapping '" << mapping->name << "' not found" << endl;
+        p.processor = system->processors.find(p.processor_name);
+        if (!p.processor) {
+            *errors << "Processor '" << *p.processor_name << "' for mapping '" << *mapping->name << "' not found" << endl;
             ret = false;
-        } else {
-            p->processor = proc->second;
         }
 
-        for (auto t : p->tasks) {
-            auto task = system->tasks.find(t->task_name);
-            if (task == system->tasks.end()) {
-                *errors << "Task '" << t->task_name << "' for mapping '" << mapping->name << "' not found" << endl;
+        for (auto &t : p.tasks) {
+            t.task = system->tasks.find(t.task_name);
+            if (!t.task) {
+                *errors << "Task '" << *t.task_name << "' for mapping '" << *mapping->name << "' not found" << endl;
                 ret = false;
             } else {
-                t->task = task->second;
+                if (hybrid && t.task->type == systemdata::TASKTYPE_FIXED) {
+                    auto first = fixed_processor.insert(make_pair(t.task, p.processor_name));
+                    if (!first.second) {
+                        *errors << "Fixed task '" << *t.task_name << "' is mapped onto both processor '" << *first.first->second
+                                << "' and processor '" << *p.processor_name << "' by mapping '" << *mapping->name << "'" << endl;
+                        ret = false;
+                    }
+                }
+
+                // Reverse index, so the builder doesn't have to search all mappings per task
+                if (t.task->mapping != mapping) {
+                    t.task->mapping = mapping;
+                    t.task->processor = p.processor;
+                }
             }
         }
     }
@@ -143,8 +221,9 @@ bool SystemValidator::validateMapping(systemdata::Mapping *mapping) {
     return ret;
 }
 
-bool SystemValidator::validateName(const string &name) {
-    for (char c : name) {
+bool SystemValidator::validateName(const systemdata::Symbol *name) {
+    for (unsigned i = 0; i < name->length; i++) {
+        char c = name->get_chars()[i];
         // Only allow 'normal' ascii characters (no spaces or special characters)
         if (c < '!' || c > '~') {
             return false;
@@ -154,22 +233,93 @@ bool SystemValidator::validateName(const string &name) {
     return true;
 }
 
+bool SystemValidator::validateFifo(systemdata::Fifo *fifo) {
+    bool ret = true;
+    if (fifo->size <= 0) {
+        *errors << "size for fifo '" << *fifo->name << "' should be > 0" << endl;
+        ret = false;
+    }
+
+    if (fifo->read_latency < 1 || fifo->read_latency > fsl_max_latency) {
+        *errors << "readLatency for fifo '" << *fifo->name << "' should be >= 1 and <= " << fsl_max_latency << endl;
+        ret = false;
+    }
+
+    if (fifo->write_latency < 1 || fifo->write_latency > fsl_max_latency) {
+        *errors << "writeLatency for fifo '" << *fifo->name << "' should be >= 1 and <= " << fsl_max_latency << endl;
+        ret = false;
+    }
+
+    if (fifo->bandwidth < 1) {
+        *errors << "bandwidth for fifo '" << *fifo->name << "' should be >= 1" << endl;
+        ret = false;
+    }
+
+    return ret;
+}
+
+bool SystemValidator::validateActor(systemdata::Actor *actor) {
+    bool ret = true;
+    if (!validateName(actor->name)) {
+        *errors << "Invalid actor name '" << *actor->name << "'" << endl;
+        ret = false;
+    }
+
+    if (!system->tasks.find(actor->name)) {
+        *errors << "Task for actor '" << *actor->name << "' not found" << endl;
+        ret = false;
+    }
+
+    for (auto &port : actor->ports) {
+        if (port.rates.size() != actor->ports[0].rates.size()) {
+            *errors << "Port '" << *port.name << "' of actor '" << *actor->name << "' has " << port.rates.size()
+                    << " rates, expected one per phase (" << actor->ports[0].rates.size() << ")" << endl;
+            ret = false;
+        }
+
+        systemdata::Fifo *fifo = system->fifos.find(port.fifo_name);
+        for (int rate : port.rates) {
+            if (rate < 0) {
+                *errors << "rates for port '" << *port.name << "' of actor '" << *actor->name << "' should be >= 0" << endl;
+                ret = false;
+                break;
+            }
+            if (fifo && rate > fifo->size) {
+                *errors << "rates for port '" << *port.name << "' of actor '" << *actor->name << "' should not exceed the size of fifo '"
+                        << *port.fifo_name << "'" << endl;
+                ret = false;
+                break;
+            }
+        }
+    }
+
+    return ret;
+}
+
 bool SystemValidator::validate() {
     // Validate all schedulers, tasks, processors and mappings
-    for (auto scheduler : system->schedulers) {
-        if (!validateScheduler(scheduler.second)) return false;
+    for (auto scheduler : system->schedulers.get()) {
+        if (!validateScheduler(scheduler)) return false;
     }
 
-    for (auto task : system->tasks) {
-        if (!validateTask(task.second)) return false;
+    for (auto task : system->tasks.get()) {
+        if (!validateTask(task)) return false;
     }
 
-    for (auto processor : system->processors) {
-        if (!validateProcessor(processor.second)) return false;
+    for (auto processor : system->processors.get()) {
+        if (!validateProcessor(processor)) return false;
     }
 
-    for (auto mapping : system->mappings) {
-        if (!validateMapping(mapping.second)) return false;
+    for (auto mapping : system->mappings.get()) {
+        if (!validateMapping(mapping)) return false;
+    }
+
+    for (auto fifo : system->fifos.get()) {
+        if (!validateFifo(fifo)) return false;
+    }
+
+    for (auto actor : system->actors.get()) {
+        if (!validateActor(actor)) return false;
     }
 
     // TODO
@@ -180,3 +330,28 @@ bool SystemValidator::validate() {
 
     return true;
 }
+
+bool SystemValidator::validateValues() {
+    for (auto scheduler : system->schedulers.get()) {
+        for (auto &slot : scheduler->slots) {
+            if (slot.start < 0 || slot.length <= 0) {
+                *errors << "Invalid slot for task '" << *slot.task_name << "' of scheduler '" << *scheduler->name << "'" << endl;
+                return false;
+            }
+        }
+    }
+
+    for (auto task : system->tasks.get()) {
+        if (!validateTask(task)) return false;
+    }
+
+    for (auto fifo : system->fifos.get()) {
+        if (!validateFifo(fifo)) return false;
+    }
+
+    for (auto actor : system->actors.get()) {
+        if (!validateActor(actor)) return false;
+    }
+
+    return true;
+}
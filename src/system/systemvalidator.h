@@ -1,7 +1,7 @@
 #ifndef SYSTEMVALIDATOR_H
 #define SYSTEMVALIDATOR_H
 
-#include <ostream>
+#include <iostream>
 #include <string>
 #include <vector>
 #include "systemdata.h"
@@ -14,14 +14,21 @@ class SystemValidator {
     bool validateTask(systemdata::Task *task);
     bool validateProcessor(systemdata::Processor *processor);
     bool validateMapping(systemdata::Mapping *mapping);
+    bool validateFifo(systemdata::Fifo *fifo);
+    bool validateActor(systemdata::Actor *actor);
     bool validateSystem(systemdata::System *system);
 
     // Helper functions
-    bool validateName(const std::string &name);
+    bool validateName(const systemdata::Symbol *name);
 
 public:
-    SystemValidator(systemdata::System *system);
+    // Errors are written to cerr, unless another stream is given
+    SystemValidator(systemdata::System *system, std::ostream &errors = std::cerr);
     bool validate();
+
+    // Only the checks on values, for a system whose links are already
+    // resolved, like one loaded from a snapshot
+    bool validateValues();
 };
 
 #endif // SYSTEMVALIDATOR_H
@@ -19,6 +19,8 @@ int main(int argc, char *argv[]) {
         if (sv.validate()) {
             ret = 0;
         }
+    } else {
+        cerr << sl.get_errors();
     }
     delete system;
 
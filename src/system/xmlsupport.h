@@ -0,0 +1,41 @@
+#ifndef XMLSUPPORT_H
+#define XMLSUPPORT_H
+
+#include <ostream>
+#include <libxml/parser.h>
+#include <libxml/xmlerror.h>
+
+#if LIBXML_VERSION >= 21200
+typedef const xmlError *XmlError;
+#else
+typedef xmlErrorPtr XmlError;
+#endif
+
+static inline bool init_libxml_once() {
+    xmlInitParser();
+    LIBXML_TEST_VERSION
+    return true;
+}
+
+// Initializes libxml2 on the first call, the other calls wait for it. The
+// loaders never call xmlCleanupParser(): it frees global state that loaders
+// in other threads may still be using.
+inline void init_libxml() {
+    static bool initialized = init_libxml_once();
+    (void)initialized;
+}
+
+// Writes an error of the parser as one line, like "file:line: message"
+inline void write_xml_error(std::ostream &errors, XmlError error) {
+    if (error->file) {
+        errors << error->file << ":" << error->line << ": ";
+    }
+
+    const char *message = error->message ? error->message : "XML error";
+    const char *end = message;
+    while (*end && *end != '\n') end++;
+    errors.write(message, end - message);
+    errors << std::endl;
+}
+
+#endif // XMLSUPPORT_H
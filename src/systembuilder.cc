@@ -1,16 +1,21 @@
 #include <iostream>
-#include "sc_schedulable_module.h"
-#include "sc_scheduler.h"
+#include <cstdlib>
+#include <climits>
+#include "schedulingkernel.h"
 #include "scheduler.h"
 #include "edfscheduler.h"
 #include "globaledfscheduler.h"
+#include "fpscheduler.h"
+#include "globalfpscheduler.h"
+#include "staticscheduler.h"
+#include "hybridedfscheduler.h"
 #include "systembuilder.h"
 #include "process.h"
 #include "monitor.h"
 using namespace std;
 
-static int gcd(int a, int b) {
-    int t;
+static long long gcd(long long a, long long b) {
+    long long t;
     while (b != 0) {
         t = b;
         b = a % b;
@@ -19,78 +24,116 @@ static int gcd(int a, int b) {
     return a;
 }
 
-static int lcm(int a, int b) {
-    return (a * b) / gcd(a, b);
+// Saturates at LLONG_MAX, large coprime periods easily overflow 32 bits
+static long long lcm(long long a, long long b) {
+    long long f = a / gcd(a, b);
+    if (f > LLONG_MAX / b) {
+        return LLONG_MAX;
+    }
+    return f * b;
 }
 
-SystemBuilder::SystemBuilder(systemdata::System *system, sc_scheduler *sc_sched) {
+SystemBuilder::SystemBuilder(systemdata::System *system, SchedulingKernel *kernel) {
     this->system = system;
-    this->sc_sched = sc_sched;
+    this->kernel = kernel;
     this->max_start_time = -1;
     this->hyperperiod = 1;
 
     // Create tasks
     for (auto t : system->get_tasks()) {
-        Task *task = new Task();
-        task_map.insert(make_pair(t.second->get_name(), task));
+        Task *task = new Task(t->get_name());
+        task->set_id(tasks.size());
+        tasks.push_back(task);
+        task_data.push_back(t);
+        task_map.insert(make_pair(t->get_name(), task));
     }
 
     // Create schedulers
     for (auto sched : system->get_schedulers()) {
         Scheduler *s;
-        switch (sched.second->get_algorithm()) {
+        switch (sched->get_algorithm()) {
             case systemdata::SCHED_EDF:
-                switch (sched.second->get_type()) {
+                switch (sched->get_type()) {
                     case systemdata::SCHEDTYPE_PARTITIONED:
                         s = new EDFScheduler();
                         break;
                     case systemdata::SCHEDTYPE_GLOBAL:
                         s = new GlobalEDFScheduler();
                         break;
+                    case systemdata::SCHEDTYPE_HYBRID:
+                        s = new HybridEDFScheduler();
+                        break;
+                    default:
+                        cerr << "Fatal error: unsupported type for EDF scheduler '" << sched->get_name() << "'" << endl;
+                        exit(1);
+                }
+                break;
+            case systemdata::SCHED_FP:
+                switch (sched->get_type()) {
+                    case systemdata::SCHEDTYPE_PARTITIONED:
+                        s = new FPScheduler();
+                        break;
+                    case systemdata::SCHEDTYPE_GLOBAL:
+                        s = new GlobalFPScheduler();
+                        break;
                     default:
-                        cerr << "Fatal error: unsupported type for EDF scheduler '" << sched.second->get_name() << "'" << endl;
+                        cerr << "Fatal error: unsupported type for FP scheduler '" << sched->get_name() << "'" << endl;
                         exit(1);
                 }
                 break;
+            case systemdata::SCHED_STATIC:
+                s = new StaticScheduler();
+                break;
             default:
-                cerr << "Fatal error: unsupported scheduling algorithm for scheduler '" << sched.second->get_name() << "'" << endl;
+                cerr << "Fatal error: unsupported scheduling algorithm for scheduler '" << sched->get_name() << "'" << endl;
                 exit(1);
         }
 
-        s->set_name(sched.second->get_name());
+        s->set_name(sched->get_name());
         scheduler_map.insert(std::make_pair(s->get_name(), s));
-        this->sc_sched->add_scheduler(s);
+        schedulers.insert(std::make_pair(sched, s));
+        this->kernel->add_scheduler(s);
     }
 
     // Create processors
     for (auto p : system->get_processors()) {
         Processor *proc = new Processor();
-        proc->set_name(p.second->get_name());
-        processor_map.insert(make_pair(p.second->get_name(), proc));
-        this->sc_sched->add_processor(proc);
+        proc->set_name(p->get_name());
+        proc->set_id(processors.size());
+        processors.push_back(proc);
+        processor_map.insert(make_pair(p->get_name(), proc));
+        this->kernel->add_processor(proc);
 
         // Find the scheduler for this processor, and register the processor with it
-        auto s = scheduler_map.find(p.second->get_scheduler()->get_name());
+        auto s = scheduler_map.find(p->get_scheduler()->get_name());
         if (s == scheduler_map.end()) {
-            cerr << "Scheduler for processor '" << p.second->get_name() << "' not found" << endl;
+            cerr << "Scheduler for processor '" << p->get_name() << "' not found" << endl;
             exit(1);
         } else {
             (*s).second->add_processor(proc);
         }
     }
 
-    // Create mappings (TODO)
-    /*auto t = taskset_map.find(sched.second->get_mapping());
-    cout << "Mapping name: " << sched.second->get_mapping()->get_name() << endl;
-    if (t == taskset_map.end()) {
-        // Create vector of task sets
-        vector<TaskSet> *tasksets = new vector<TaskSet>(sched.second->get_mapping().get_entries().size());
-        //for (auto it : sched.second->get_mapping().get_entries()) {
-            //tasksets
-        //}
-    } else {
-        cout << "Mapping found" << endl;
-    }*/
+    // Create a task set per processor entry of the mapping of each scheduler
+    for (auto sched : system->get_schedulers()) {
+        Scheduler *s = scheduler_map[sched->get_name()];
+        for (auto &pe : sched->get_mapping()->get_entries()) {
+            TaskSet *taskset = new TaskSet(processor_map[pe.get_processor()->get_name()]);
+            for (auto &te : pe.get_task_entries()) {
+                taskset->add_task(task_map[te.get_task()->get_name()]);
+            }
+            s->add_taskset(taskset);
+            this->kernel->add_taskset(taskset);
+        }
+
+        // Explicit dispatch table
+        if (sched->get_algorithm() == systemdata::SCHED_STATIC) {
+            StaticScheduler *ss = static_cast<StaticScheduler*>(s);
+            for (auto &slot : sched->get_slots()) {
+                ss->add_slot(processor_map[slot.get_processor_name()], task_map[slot.get_task_name()], slot.get_start(), slot.get_length());
+            }
+        }
+    }
 }
 
 int SystemBuilder::get_num_schedulers() const {
@@ -106,106 +149,104 @@ int SystemBuilder::get_fifo_size(const char *name, int def) const {
     return fifo->get_size();
 }
 
+int SystemBuilder::get_fifo_read_latency(const char *name) const {
+    const systemdata::Fifo *fifo = system->get_fifo(name);
+    return fifo ? fifo->get_read_latency() : 1;
+}
+
+int SystemBuilder::get_fifo_write_latency(const char *name) const {
+    const systemdata::Fifo *fifo = system->get_fifo(name);
+    return fifo ? fifo->get_write_latency() : 1;
+}
+
+int SystemBuilder::get_fifo_bandwidth(const char *name) const {
+    const systemdata::Fifo *fifo = system->get_fifo(name);
+    return fifo ? fifo->get_bandwidth() : 1;
+}
+
 void SystemBuilder::create_processors(std::vector<Processor*> &processors) {
-    for (auto p : processor_map) {
-        processors.push_back(p.second);
+    for (auto p : this->processors) {
+        processors.push_back(p);
     }
 }
 
 void SystemBuilder::set_delays(const char *name, Process *process) {
-    auto t = system->get_tasks().find(name);
-    if (t == system->get_tasks().end()) {
+    const systemdata::Task *t = system->get_task(name);
+    if (!t) {
         cerr << "No delays found for task '" << name << "'" << endl;
         exit(1);
     }
-    process->set_delays(t->second->get_read_delay(), t->second->get_wcet(), t->second->get_write_delay());
+    process->set_delays(t->get_read_delay(), t->get_wcet(), t->get_write_delay());
 }
 
 void SystemBuilder::set_scheduling_parameters(Task *task, Scheduler *scheduler) const {
-    auto t = system->get_tasks().find(task->get_name());
+    const systemdata::Task *t = task->get_id() < static_cast<int>(task_data.size()) ? task_data[task->get_id()] : NULL;
 
-    if (t == system->get_tasks().end()) {
+    if (!t) {
         cerr << "Information for task '" << task->get_name() << "' not found." << endl;
         exit(1);
     } else {
         // wcet is composed of task wcet + read delay + write delay
-        int wcet = t->second->get_wcet() + t->second->get_read_delay() + t->second->get_write_delay();
-        int start_time = t->second->get_start_time();
-        int period = t->second->get_period();
-        int deadline = t->second->get_deadline();
-        int priority = t->second->get_priority();
+        int wcet = t->get_wcet() + t->get_read_delay() + t->get_write_delay();
+        int start_time = t->get_start_time();
+        int period = t->get_period();
+        int deadline = t->get_deadline();
+        int priority = t->get_priority();
+        int migrating = t->get_type() == systemdata::TASKTYPE_MIGRATING;
         scheduler->set_parameter(task, PARAM_WCET, static_cast<const void*>(&wcet));
         scheduler->set_parameter(task, PARAM_START_TIME, static_cast<const void*>(&start_time));
         scheduler->set_parameter(task, PARAM_PERIOD, static_cast<const void*>(&period));
         scheduler->set_parameter(task, PARAM_DEADLINE, static_cast<const void*>(&deadline));
         scheduler->set_parameter(task, PARAM_PRIORITY, static_cast<const void*>(&priority));
+        scheduler->set_parameter(task, PARAM_MIGRATING, static_cast<const void*>(&migrating));
     }
 }
 
 void SystemBuilder::set_monitoring_parameters(Monitor *monitor) const {
-    for (auto task : task_map) {
-
-        auto t = system->get_tasks().find(task.second->get_name());
+    for (auto task : tasks) {
+        const systemdata::Task *t = task_data[task->get_id()];
 
         // wcet is composed of task wcet + read delay + write delay
-        int wcet = t->second->get_wcet() + t->second->get_read_delay() + t->second->get_write_delay();
-        int start_time = t->second->get_start_time();
-        int period = t->second->get_period();
-        int deadline = t->second->get_deadline();
-        int priority = t->second->get_priority();
-
-        monitor->set_parameter(task.second, PARAM_WCET, static_cast<const void*>(&wcet));
-        monitor->set_parameter(task.second, PARAM_START_TIME, static_cast<const void*>(&start_time));
-        monitor->set_parameter(task.second, PARAM_PERIOD, static_cast<const void*>(&period));
-        monitor->set_parameter(task.second, PARAM_DEADLINE, static_cast<const void*>(&deadline));
-        monitor->set_parameter(task.second, PARAM_PRIORITY, static_cast<const void*>(&priority));
+        int wcet = t->get_wcet() + t->get_read_delay() + t->get_write_delay();
+        int start_time = t->get_start_time();
+        int period = t->get_period();
+        int deadline = t->get_deadline();
+        int priority = t->get_priority();
+
+        monitor->set_parameter(task, PARAM_WCET, static_cast<const void*>(&wcet));
+        monitor->set_parameter(task, PARAM_START_TIME, static_cast<const void*>(&start_time));
+        monitor->set_parameter(task, PARAM_PERIOD, static_cast<const void*>(&period));
+        monitor->set_parameter(task, PARAM_DEADLINE, static_cast<const void*>(&deadline));
+        monitor->set_parameter(task, PARAM_PRIORITY, static_cast<const void*>(&priority));
     }
 }
 
 Scheduler* SystemBuilder::get_scheduler_for_task(const char *name) const {
-    systemdata::Task *task;
-    auto t = system->get_tasks().find(name);
-    if (t == system->get_tasks().end()) {
+    const systemdata::Task *task = system->get_task(name);
+    if (!task) {
         cerr << "Couldn't find task information for '" << name << "'" << endl;
         exit(1);
     }
-    task = t->second;
 
-    // Find the mapping in which the task appears
-    systemdata::Mapping *mapping = NULL;
-    for (auto m : system->get_mappings()) {
-        for (auto pe : m.second->get_entries()) {
-            for (auto te : pe->get_task_entries()) {
-                if (te->get_task()->get_name() == name) {
-                    mapping = m.second;
-                    break;
-                }
-            }
-        }
-    }
+    return get_scheduler_for_task(task);
+}
 
+Scheduler* SystemBuilder::get_scheduler_for_task(const systemdata::Task *task) const {
+    // Resolved by SystemValidator, which indexes every task entry of every mapping once
+    systemdata::Mapping *mapping = task->get_mapping();
     if (!mapping) {
-        // SystemValidator should have checked this
-        cerr << "Internal error: task '" << name << "' does not appear in a mapping" << endl;
+        cerr << "Internal error: task '" << task->get_name() << "' does not appear in a mapping" << endl;
         exit(1);
     }
 
-    // Find scheduler that uses this mapping
-    systemdata::Scheduler *scheduler = NULL;
-    for (auto s : system->get_schedulers()) {
-        if (s.second->get_mapping() == mapping) {
-            scheduler = s.second;
-            break;
-        }
-    }
-
+    systemdata::Scheduler *scheduler = mapping->get_scheduler();
     if (!scheduler) {
         cerr << "Mapping '" << mapping->get_name() << "' is not used by any scheduler" << endl;
         exit(1);
     }
 
-    auto s = scheduler_map.find(scheduler->get_name());
-    if (s == scheduler_map.end()) {
+    auto s = schedulers.find(scheduler);
+    if (s == schedulers.end()) {
         // This should never happen
         cerr << "Internal error: no sc_scheduler object found for scheduler '" << scheduler->get_name() << "'" << endl;
         exit(1);
@@ -214,39 +255,57 @@ Scheduler* SystemBuilder::get_scheduler_for_task(const char *name) const {
     return s->second;
 }
 
-void SystemBuilder::create_task(sc_schedulable_module *sc_mod) {
+Task* SystemBuilder::create_task(const std::string &name, sc_schedulable_module *module) {
     Task *task;
-    auto t = task_map.find(sc_mod->name());
+    auto t = task_map.find(name);
     if (t == task_map.end()) {
-        cerr << "Couldn't find task information for process '" << sc_mod->name() << endl;
+        cerr << "Couldn't find task information for process '" << name << "'" << endl;
+        exit(1);
     }
     task = t->second;
 
-    task->set_module(sc_mod);
+    task->set_module(module);
 
     // Register the task with its scheduler
     // TODO: Multiple schedulers for task
-    this->sc_sched->add_task(task);
-    Scheduler *sched = get_scheduler_for_task(sc_mod->name());
+    this->kernel->add_task(task);
+    const systemdata::Task *ts = task_data[task->get_id()];
+    Scheduler *sched = get_scheduler_for_task(ts);
     sched->add_task(task);
 
     this->set_scheduling_parameters(task, sched);
 
     // Update information for default simulation time
-    auto ts = system->get_tasks().find(task->get_name());
-    if (ts == system->get_tasks().end()) {
-        cerr << "Information for task '" << task->get_name() << "' not found." << endl;
-        exit(1);
-    } else {
-        int start_time = ts->second->get_start_time();
-        int period = ts->second->get_period();
-        if (start_time > this->max_start_time) {
-            this->max_start_time = start_time;
-        }
-        this->hyperperiod = lcm(this->hyperperiod, period);
+    int start_time = ts->get_start_time();
+    int period = ts->get_period();
+    if (start_time > this->max_start_time) {
+        this->max_start_time = start_time;
+    }
+    this->hyperperiod = lcm(this->hyperperiod, period);
+
+    return task;
+}
+
+void SystemBuilder::create_tasks() {
+    // Register every task of the system without a SystemC process
+    for (auto t : system->get_tasks()) {
+        create_task(t->get_name());
     }
 }
 
 int SystemBuilder::get_default_simulation_time() const {
+    if (this->hyperperiod > (INT_MAX - this->max_start_time) / 2) {
+        cerr << "Warning: hyperperiod of " << this->hyperperiod
+             << " too large, limiting the simulation time to " << INT_MAX << endl;
+        return INT_MAX;
+    }
     return this->max_start_time + 2*this->hyperperiod;
 }
+
+long long SystemBuilder::get_hyperperiod() const {
+    return this->hyperperiod;
+}
+
+int SystemBuilder::get_max_start_time() const {
+    return this->max_start_time;
+}
@@ -8,31 +8,42 @@
 class Process;
 class Processor;
 class Scheduler;
-class sc_scheduler;
+class SchedulingKernel;
 class sc_schedulable_module;
 class Task;
 class Monitor;
 
 class SystemBuilder {
-    sc_scheduler *sc_sched;
+    SchedulingKernel *kernel;
     systemdata::System *system;
+    std::vector<Task*> tasks;               // Indexed by task id
+    std::vector<const systemdata::Task*> task_data;     // Indexed by task id
+    std::vector<Processor*> processors;     // Indexed by processor id
     std::unordered_map<std::string, Task*> task_map;
     std::unordered_map<std::string, Processor*> processor_map;
     std::unordered_map<std::string, Scheduler*> scheduler_map;
-    //std::unordered_map<systemdata::Mapping*, std::vector<TaskSet>*> taskset_map;
+    std::unordered_map<const systemdata::Scheduler*, Scheduler*> schedulers;
     int max_start_time;
-    int hyperperiod;
+    long long hyperperiod;
+
+    Scheduler* get_scheduler_for_task(const systemdata::Task *task) const;
 public:
-    SystemBuilder(systemdata::System *system, sc_scheduler *sc_sched);
+    SystemBuilder(systemdata::System *system, SchedulingKernel *kernel);
     int get_fifo_size(const char *name, int def) const;
+    int get_fifo_read_latency(const char *name) const;
+    int get_fifo_write_latency(const char *name) const;
+    int get_fifo_bandwidth(const char *name) const;
     int get_num_schedulers() const;
     void create_processors(std::vector<Processor*> &processors);
     void set_delays(const char *name, Process *process);
     void set_scheduling_parameters(Task *task, Scheduler *scheduler) const;
     void set_monitoring_parameters(Monitor *monitor) const;
     Scheduler* get_scheduler_for_task(const char *name) const;
-    void create_task(sc_schedulable_module *sc_mod);
+    Task* create_task(const std::string &name, sc_schedulable_module *module = NULL);
+    void create_tasks();
     int get_default_simulation_time() const;
+    long long get_hyperperiod() const;
+    int get_max_start_time() const;
 };
 
 #endif // SYSTEMBUILDER_H
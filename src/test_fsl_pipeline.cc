@@ -0,0 +1,87 @@
+#include <iostream>
+#include <vector>
+#include "fsl_pipeline.h"
+using namespace std;
+
+// Checks the delay line of the fsl FIFOs for every supported latency: an item
+// pushed between two clock edges comes out at the L-th edge after its push,
+// for pushes in every cycle as well as with idle cycles in between.
+
+// Pushes item i before edge push_edges[i] (edges counted from 1) and checks
+// that it comes out at edge push_edges[i] + L - 1
+template <int L>
+static bool check(const char *pattern, const vector<int> &push_edges) {
+    fsl_pipeline<int, L> pipeline;
+    size_t next_push = 0;
+    size_t next_out = 0;
+    int last_edge = push_edges.empty() ? 0 : push_edges.back() + L;
+
+    for (int edge = 1; edge <= last_edge; edge++) {
+        if (next_push < push_edges.size() && push_edges[next_push] == edge) {
+            pipeline.push(next_push);
+            if (!pipeline.pushed()) {
+                cerr << "L=" << L << ", " << pattern << ": push before edge " << edge << " not seen" << endl;
+                return false;
+            }
+            next_push++;
+        }
+
+        int value;
+        if (pipeline.advance(value)) {
+            if (next_out >= push_edges.size() || value != static_cast<int>(next_out)) {
+                cerr << "L=" << L << ", " << pattern << ": unexpected item " << value << " at edge " << edge << endl;
+                return false;
+            }
+            if (edge != push_edges[next_out] + L - 1) {
+                cerr << "L=" << L << ", " << pattern << ": item " << value << " pushed before edge " << push_edges[next_out]
+                     << " came out at edge " << edge << ", expected " << push_edges[next_out] + L - 1 << endl;
+                return false;
+            }
+            next_out++;
+        }
+
+        if (pipeline.pushed()) {
+            cerr << "L=" << L << ", " << pattern << ": push still pending after edge " << edge << endl;
+            return false;
+        }
+        if (pipeline.size() != static_cast<int>(next_push - next_out)) {
+            cerr << "L=" << L << ", " << pattern << ": size " << pipeline.size() << " after edge " << edge
+                 << ", expected " << next_push - next_out << endl;
+            return false;
+        }
+    }
+
+    if (next_out != push_edges.size() || !pipeline.empty()) {
+        cerr << "L=" << L << ", " << pattern << ": " << push_edges.size() - next_out << " items did not come out" << endl;
+        return false;
+    }
+    return true;
+}
+
+template <int L>
+static bool check_latency() {
+    vector<int> single, back_to_back, alternating, gaps;
+    single.push_back(1);
+    for (int i = 0; i < 20; i++) {
+        back_to_back.push_back(1 + i);
+        alternating.push_back(1 + 2 * i);
+    }
+    // Bursts of back-to-back pushes separated by idle cycles of varying length
+    const int gap_edges[] = { 1, 2, 3, 6, 7, 11, 14, 15, 16, 17, 22, 24 };
+    gaps.assign(gap_edges, gap_edges + sizeof(gap_edges) / sizeof(gap_edges[0]));
+
+    return check<L>("single push", single) &&
+           check<L>("back-to-back pushes", back_to_back) &&
+           check<L>("alternating pushes", alternating) &&
+           check<L>("pushes with gaps", gaps);
+}
+
+int main() {
+    bool ok = check_latency<1>() && check_latency<2>() && check_latency<3>() && check_latency<4>();
+    static_assert(fsl_max_latency == 4, "check every latency make_fsl() supports");
+
+    if (ok) {
+        cout << "fsl_pipeline: latencies 1.." << fsl_max_latency << " ok" << endl;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include <iostream>
+#include <utility>
+#include <vector>
+#include "fsl_token_pool.h"
+using namespace std;
+
+// Checks the reference counting of fsl_token handles: a slot returns to its
+// pool exactly when the last handle to it is released, whether the handles
+// were copied, moved, assigned or destroyed.
+
+typedef vector<int> Frame;
+
+static bool expect(bool condition, const char *what) {
+    if (!condition) {
+        cerr << "fsl_token_pool: " << what << endl;
+    }
+    return condition;
+}
+
+static bool check_copies() {
+    fsl_token_pool<Frame> pool(2);
+    bool ok = expect(pool.size() == 2 && pool.available() == 2, "new pool is not empty");
+
+    fsl_token<Frame> a = pool.allocate();
+    a->assign(4, 7);
+    ok = ok && expect(pool.available() == 1, "allocate does not take a slot");
+    {
+        fsl_token<Frame> b(a);
+        fsl_token<Frame> c;
+        c = b;
+        ok = ok && expect(b.get_slot() == a.get_slot() && c.get_slot() == a.get_slot(), "copies point to another slot");
+        ok = ok && expect((*c)[3] == 7, "copy does not share the payload");
+        b.release();
+        ok = ok && expect(!b && c && pool.available() == 1, "releasing a copy frees the slot");
+    }
+    ok = ok && expect(pool.available() == 1, "destroying the copies frees the slot");
+    a.release();
+    ok = ok && expect(!a && pool.available() == 2, "releasing the last handle keeps the slot");
+    return ok;
+}
+
+static bool check_moves() {
+    fsl_token_pool<Frame> pool(2);
+    fsl_token<Frame> a = pool.allocate();
+    int slot = a.get_slot();
+
+    fsl_token<Frame> b(std::move(a));
+    bool ok = expect(!a && b.get_slot() == slot && pool.available() == 1, "move construction changes the count");
+
+    fsl_token<Frame> c = pool.allocate();
+    c = std::move(b);
+    ok = ok && expect(!b && c.get_slot() == slot, "move assignment does not take over the slot");
+    ok = ok && expect(pool.available() == 1, "move assignment does not free the overwritten slot");
+
+    c = fsl_token<Frame>();
+    ok = ok && expect(!c && pool.available() == 2, "assigning an empty handle keeps the slot");
+
+    c = c;
+    ok = ok && expect(!c && pool.available() == 2, "self-assignment changes the count");
+    return ok;
+}
+
+// Freed slots are handed out again, so a FIFO of handles never needs more
+// slots than tokens in flight
+static bool check_reuse() {
+    fsl_token_pool<Frame> pool(3);
+    vector<fsl_token<Frame> > fifo;
+    bool ok = true;
+    for (int i = 0; ok && i < 100; i++) {
+        fifo.push_back(pool.allocate());
+        (*fifo.back()).assign(1, i);
+        if (fifo.size() == 3) {
+            ok = expect((*fifo.front())[0] == i - 2, "payload changed while in flight");
+            fifo.erase(fifo.begin());
+        }
+        ok = ok && expect(pool.available() == 3 - static_cast<int>(fifo.size()), "slots leak while streaming");
+    }
+    fifo.clear();
+    return ok && expect(pool.available() == 3, "slots left in use");
+}
+
+int main() {
+    bool ok = check_copies() && check_moves() && check_reuse();
+    if (ok) {
+        cout << "fsl_token_pool: ok" << endl;
+    }
+    return ok ? 0 : 1;
+}